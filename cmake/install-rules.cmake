@@ -1,5 +1,9 @@
 install(TARGETS bython_driver RUNTIME COMPONENT bython_Runtime)
 
+# Executables compiled ahead of time link against the runtime, which the driver looks for in
+# ../lib relative to itself
+install(TARGETS bython_runtime ARCHIVE DESTINATION lib COMPONENT bython_Runtime)
+
 if(PROJECT_IS_TOP_LEVEL)
   include(CPack)
 endif()
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "ast/arena.hpp"
 #include "ast/bases.hpp"
 #include "ast/expression.hpp"
+#include "ast/folding.hpp"
 #include "ast/module.hpp"
 #include "ast/operators.hpp"
 #include "ast/statement.hpp"
+#include "ast/symbol.hpp"
 #include "ast/visitor.hpp"
\ No newline at end of file
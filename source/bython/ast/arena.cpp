@@ -0,0 +1,125 @@
+#include <memory>
+#include <utility>
+
+#include "arena.hpp"
+
+static thread_local auto active_arena = static_cast<bython::ast::arena*>(nullptr);
+
+namespace bython::ast
+{
+arena::arena(std::size_t block_size)
+    : m_block_size {block_size}
+{
+}
+
+arena::arena(arena&& other) noexcept
+    : m_blocks {std::move(other.m_blocks)}
+    , m_cursor {std::exchange(other.m_cursor, nullptr)}
+    , m_end {std::exchange(other.m_end, nullptr)}
+    , m_block_size {other.m_block_size}
+    , m_bytes_allocated {std::exchange(other.m_bytes_allocated, 0)}
+{
+}
+
+auto arena::operator=(arena&& other) noexcept -> arena&
+{
+  this->m_blocks = std::move(other.m_blocks);
+  this->m_cursor = std::exchange(other.m_cursor, nullptr);
+  this->m_end = std::exchange(other.m_end, nullptr);
+  this->m_block_size = other.m_block_size;
+  this->m_bytes_allocated = std::exchange(other.m_bytes_allocated, 0);
+  return *this;
+}
+
+auto arena::allocate(std::size_t size, std::size_t alignment) -> void*
+{
+  this->m_bytes_allocated += size;
+
+  // Oversized requests get a dedicated block so that the current one keeps its tail
+  if (size + alignment > this->m_block_size) {
+    auto space = size + alignment;
+    auto& block = this->m_blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(space));
+
+    void* aligned = block.get();
+    return std::align(alignment, size, aligned, space);
+  }
+
+  void* aligned = this->m_cursor;
+  auto space = static_cast<std::size_t>(this->m_end - this->m_cursor);
+
+  if (this->m_cursor == nullptr || std::align(alignment, size, aligned, space) == nullptr) {
+    auto& block = this->m_blocks.emplace_back(
+        std::make_unique_for_overwrite<std::byte[]>(this->m_block_size));
+    this->m_end = block.get() + this->m_block_size;
+
+    aligned = block.get();
+    space = this->m_block_size;
+    std::align(alignment, size, aligned, space);
+  }
+
+  this->m_cursor = static_cast<std::byte*>(aligned) + size;
+  return aligned;
+}
+
+auto arena::bytes_allocated() const -> std::size_t
+{
+  return this->m_bytes_allocated;
+}
+
+tree::tree(node_ptr<node> root)
+    : m_nodes {}
+    , m_root {std::move(root)}
+{
+}
+
+tree::tree(arena nodes, node_ptr<node> root)
+    : m_nodes {std::move(nodes)}
+    , m_root {std::move(root)}
+{
+}
+
+auto tree::operator=(tree&& other) noexcept -> tree&
+{
+  // The old nodes must go before the arena holding them
+  this->m_root.reset();
+  this->m_nodes = std::move(other.m_nodes);
+  this->m_root = std::move(other.m_root);
+  return *this;
+}
+
+auto tree::get() const -> node*
+{
+  return this->m_root.get();
+}
+
+auto tree::operator*() const -> node&
+{
+  return *this->m_root;
+}
+
+auto tree::operator->() const -> node*
+{
+  return this->m_root.get();
+}
+
+auto tree::nodes() const -> arena const&
+{
+  return this->m_nodes;
+}
+
+arena_scope::arena_scope(arena& target)
+    : m_previous {active_arena}
+{
+  active_arena = &target;
+}
+
+arena_scope::~arena_scope()
+{
+  active_arena = this->m_previous;
+}
+
+auto current_arena() -> arena*
+{
+  return active_arena;
+}
+}  // namespace bython::ast
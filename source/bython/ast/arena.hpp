@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "bases.hpp"
+
+namespace bython::ast
+{
+
+/// Bump allocator for AST nodes. Nodes are placement-constructed back to back into large blocks,
+/// so siblings share cache lines, and all blocks are released together when the arena dies.
+/// Every node allocated from an arena must be destroyed before the arena itself.
+class arena
+{
+public:
+  static constexpr std::size_t default_block_size = 64 * 1024;
+
+  explicit arena(std::size_t block_size = default_block_size);
+
+  arena(arena const&) = delete;
+  auto operator=(arena const&) -> arena& = delete;
+
+  // A moved-from arena starts a fresh block on its next allocation rather than writing into
+  // blocks it no longer owns
+  arena(arena&& other) noexcept;
+  auto operator=(arena&& other) noexcept -> arena&;
+
+  ~arena() = default;
+
+  auto allocate(std::size_t size, std::size_t alignment) -> void*;
+
+  template<typename T, typename... Args>
+  auto make(Args&&... args) -> node_ptr<T>
+  {
+    auto* storage = this->allocate(sizeof(T), alignof(T));
+    auto* instance = ::new (storage) T(std::forward<Args>(args)...);
+    instance->m_arena_owned = true;
+    return node_ptr<T>(instance);
+  }
+
+  auto bytes_allocated() const -> std::size_t;
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+  std::byte* m_cursor = nullptr;
+  std::byte* m_end = nullptr;
+
+  std::size_t m_block_size;
+  std::size_t m_bytes_allocated = 0;
+};
+
+/// An AST root together with the arena its nodes live in. The root is declared last so that all
+/// nodes are destroyed before the arena releases their storage.
+class tree
+{
+public:
+  explicit tree(node_ptr<node> root);
+  tree(arena nodes, node_ptr<node> root);
+
+  tree(tree&&) noexcept = default;
+  auto operator=(tree&& other) noexcept -> tree&;
+
+  ~tree() = default;
+
+  auto get() const -> node*;
+  auto operator*() const -> node&;
+  auto operator->() const -> node*;
+
+  auto nodes() const -> arena const&;
+
+private:
+  arena m_nodes;
+  node_ptr<node> m_root;
+};
+
+/// Routes `make_node` on the calling thread into `target` for the lifetime of the scope
+class arena_scope
+{
+public:
+  explicit arena_scope(arena& target);
+  ~arena_scope();
+
+  arena_scope(arena_scope const&) = delete;
+  auto operator=(arena_scope const&) -> arena_scope& = delete;
+
+private:
+  arena* m_previous;
+};
+
+/// The arena installed by the innermost `arena_scope` on the calling thread, if any
+auto current_arena() -> arena*;
+
+/// Allocates a node from the current arena, falling back to the heap outside of an `arena_scope`
+template<typename T, typename... Args>
+auto make_node(Args&&... args) -> node_ptr<T>
+{
+  if (auto* target = current_arena(); target != nullptr) {
+    return target->make<T>(std::forward<Args>(args)...);
+  }
+  return node_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+}  // namespace bython::ast
@@ -1,14 +1,27 @@
 #include "bases.hpp"
 
-#include <boost/uuid/uuid.hpp>  // uuid class
-#include <boost/uuid/uuid_generators.hpp>  // generators
-
-static thread_local auto uuid_generator = boost::uuids::random_generator {};
+static thread_local auto next_node_id = bython::ast::node_id {0};
 
 namespace bython::ast
 {
+auto reset_node_ids() -> void
+{
+  next_node_id = 0;
+}
+
 node::node()
-    : uuid {uuid_generator()}
+    : id {next_node_id++}
+{
+}
+
+node::node(node const& other)
+    : id {other.id}
+{
+}
+
+auto node::operator=(node const& other) -> node&
 {
+  this->id = other.id;
+  return *this;
 }
-}  // namespace bython::ast
\ No newline at end of file
+}  // namespace bython::ast
@@ -1,59 +1,126 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <memory>
 
-#include <boost/uuid/uuid.hpp>
-
 #include "tags.hpp"
 
 namespace bython::ast
 {
 
+/// Dense identifier of a node, numbered from zero within each parse
+using node_id = std::uint32_t;
+
+/// Restarts node numbering on the calling thread; frontends call this before each parse
+auto reset_node_ids() -> void;
+
+class arena;
+struct node_deleter;
+
 struct node
 {
   node();
 
+  // Copies keep the node's identity but never its storage ownership
+  node(node const& other);
+  auto operator=(node const& other) -> node&;
+
   virtual ~node() = default;
 
   virtual auto tag() const -> ast::tag = 0;
 
-  boost::uuids::uuid uuid;
+  static auto classof(node const* /*ast*/) -> bool
+  {
+    return true;
+  }
+
+  node_id id;
+
+private:
+  friend class arena;
+  friend struct node_deleter;
+
+  bool m_arena_owned = false;
+};
+
+/// Destroys heap-allocated nodes outright; nodes placed in an `arena` are only destructed, as
+/// their storage is released wholesale by the arena
+struct node_deleter
+{
+  node_deleter() = default;
+
+  template<typename T>
+  node_deleter(std::default_delete<T> const& /*heap*/) noexcept
+  {
+  }
+
+  auto operator()(node const* ast) const -> void
+  {
+    if (ast->m_arena_owned) {
+      ast->~node();
+    } else {
+      delete ast;
+    }
+  }
 };
 
+template<typename T>
+using node_ptr = std::unique_ptr<T, node_deleter>;
+
+/*
+ * LLVM-style RTTI: every node type provides `static auto classof(node const*) -> bool`,
+ * which decides membership from `node::tag` alone, so casts never consult C++ RTTI.
+ */
+
 template<typename T>
 auto isa(node const* ast) -> bool
 {
-  return dynamic_cast<T*>(ast) != nullptr;
+  return ast != nullptr && T::classof(ast);
 }
 
 template<typename T>
 auto isa(node const& ast) -> bool
 {
-  return dynamic_cast<T*>(&ast) != nullptr;
+  return T::classof(&ast);
+}
+
+template<typename T>
+auto cast(node const& ast) -> T const&
+{
+  assert(isa<T>(ast) && "cast<T>() argument of incompatible type!");
+  return static_cast<T const&>(ast);
+}
+
+template<typename T>
+auto cast(node& ast) -> T&
+{
+  assert(isa<T>(ast) && "cast<T>() argument of incompatible type!");
+  return static_cast<T&>(ast);
 }
 
 template<typename T>
 auto dyn_cast(node const* ast) -> T const*
 {
-  return dynamic_cast<T const*>(ast);
+  return isa<T>(ast) ? static_cast<T const*>(ast) : nullptr;
 }
 
 template<typename T>
 auto dyn_cast(node* ast) -> T*
 {
-  return dynamic_cast<T*>(ast);
+  return isa<T>(ast) ? static_cast<T*>(ast) : nullptr;
 }
 
 template<typename T>
 auto dyn_cast(node const& ast) -> T const*
 {
-  return dynamic_cast<T const*>(&ast);
+  return isa<T>(ast) ? static_cast<T const*>(&ast) : nullptr;
 }
 
 template<typename T>
 auto dyn_cast(node& ast) -> T*
 {
-  return dynamic_cast<T*>(&ast);
+  return isa<T>(ast) ? static_cast<T*>(&ast) : nullptr;
 }
 
-}  // namespace bython::ast
\ No newline at end of file
+}  // namespace bython::ast
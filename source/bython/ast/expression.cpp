@@ -4,7 +4,7 @@
 
 namespace bython::ast
 {
-unary_operation::unary_operation(unop_tag op_, std::unique_ptr<expression> rhs_)
+unary_operation::unary_operation(unop_tag op_, expression_ptr rhs_)
     : op {op_}
     , rhs {std::move(rhs_)}
 {
@@ -15,9 +15,9 @@ auto unary_operation::tag() const -> ast::tag
   return ast::tag {tag::unary_operation};
 }
 
-binary_operation::binary_operation(std::unique_ptr<expression> lhs_,
+binary_operation::binary_operation(expression_ptr lhs_,
                                    binop_tag binop_,
-                                   std::unique_ptr<expression> rhs_)
+                                   expression_ptr rhs_)
     : lhs {std::move(lhs_)}
     , op {binop_}
     , rhs {std::move(rhs_)}
@@ -29,9 +29,9 @@ auto binary_operation::tag() const -> ast::tag
   return ast::tag {tag::binary_operation};
 }
 
-comparison::comparison(std::unique_ptr<expression> lhs_,
+comparison::comparison(expression_ptr lhs_,
                        ast::comparison_operator_tag comp_op,
-                       std::unique_ptr<expression> rhs_)
+                       expression_ptr rhs_)
     : lhs {std::move(lhs_)}
     , op {std::move(comp_op)}
     , rhs {std::move(rhs_)}
@@ -53,8 +53,8 @@ auto argument_list::tag() const -> ast::tag
   return ast::tag {tag::argument_list};
 }
 
-call::call(std::string callee_, argument_list arguments_)
-    : callee {std::move(callee_)}
+call::call(symbol callee_, argument_list arguments_)
+    : callee {callee_}
     , arguments {std::move(arguments_)}
 {
 }
@@ -64,8 +64,8 @@ auto call::tag() const -> ast::tag
   return ast::tag {tag::call};
 }
 
-variable::variable(std::string identifier_)
-    : identifier {std::move(identifier_)}
+variable::variable(symbol identifier_)
+    : identifier {identifier_}
 {
 }
 
@@ -94,4 +94,14 @@ auto unsigned_integer::tag() const -> ast::tag
   return ast::tag {tag::unsigned_integer};
 }
 
+boolean::boolean(bool value_)
+    : value {value_}
+{
+}
+
+auto boolean::tag() const -> ast::tag
+{
+  return ast::tag {tag::boolean};
+}
+
 }  // namespace bython::ast
\ No newline at end of file
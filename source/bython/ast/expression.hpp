@@ -1,64 +1,88 @@
 #pragma once
 
 #include <memory>
-#include <string>
 #include <vector>
 
 #include "bases.hpp"
 #include "operators.hpp"
+#include "symbol.hpp"
 
 namespace bython::ast
 {
 struct expression : node
 {
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag().is_expression();
+  }
 };
 
-using expression_ptr = std::unique_ptr<expression>;
+using expression_ptr = node_ptr<expression>;
 using expressions = std::vector<expression_ptr>;
 
 struct unary_operation final : expression
 {
-  unary_operation(unop_tag op_, std::unique_ptr<expression> rhs_);
+  unary_operation(unop_tag op_, expression_ptr rhs_);
 
   unary_operator op;
-  std::unique_ptr<expression> rhs;
+  expression_ptr rhs;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::unary_operation;
+  }
 };
 
 struct binary_operation final : expression
 {
-  binary_operation(std::unique_ptr<expression> lhs_,
+  binary_operation(expression_ptr lhs_,
                    binop_tag binop_,
-                   std::unique_ptr<expression> rhs_);
+                   expression_ptr rhs_);
 
-  std::unique_ptr<expression> lhs;
+  expression_ptr lhs;
   binary_operator op;
-  std::unique_ptr<expression> rhs;
+  expression_ptr rhs;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::binary_operation;
+  }
 };
 
 struct comparison final : expression
 {
-  comparison(std::unique_ptr<expression> lhs_,
+  comparison(expression_ptr lhs_,
              ast::comparison_operator_tag comp_op,
-             std::unique_ptr<expression> rhs_);
+             expression_ptr rhs_);
 
-  std::unique_ptr<expression> lhs;
+  expression_ptr lhs;
   ast::comparison_operator op;
-  std::unique_ptr<expression> rhs;
+  expression_ptr rhs;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::comparison;
+  }
 };
 
 struct variable final : expression
 {
-  explicit variable(std::string identifier_);
+  explicit variable(symbol identifier_);
 
-  std::string identifier;
+  symbol identifier;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::variable;
+  }
 };
 
 struct argument_list final : node
@@ -67,16 +91,26 @@ struct argument_list final : node
   ast::expressions arguments;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::argument_list;
+  }
 };
 
 struct call final : expression
 {
-  call(std::string callee_, argument_list arguments_);
+  call(symbol callee_, argument_list arguments_);
 
-  std::string callee;
+  symbol callee;
   argument_list arguments;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::call;
+  }
 };
 
 struct signed_integer final : expression
@@ -86,6 +120,11 @@ struct signed_integer final : expression
   int64_t value;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::signed_integer;
+  }
 };
 
 struct unsigned_integer final : expression
@@ -95,6 +134,26 @@ struct unsigned_integer final : expression
   uint64_t value;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::unsigned_integer;
+  }
+};
+
+/// Truth value; not written in source, but produced by folding constant comparisons
+struct boolean final : expression
+{
+  explicit boolean(bool value_);
+
+  bool value;
+
+  auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::boolean;
+  }
 };
 
 }  // namespace bython::ast
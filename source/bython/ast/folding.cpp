@@ -0,0 +1,346 @@
+#include <cstdint>
+#include <optional>
+
+#include "folding.hpp"
+
+#include "arena.hpp"
+#include "expression.hpp"
+#include "module.hpp"
+#include "operators.hpp"
+#include "statement.hpp"
+
+namespace
+{
+using namespace bython::ast;
+
+/// An integer literal as the type system sees it: its signedness, the width inference gives it,
+/// and its value as a two's complement bit pattern of that width
+struct integer_constant
+{
+  bool is_signed;
+  unsigned width;
+  std::uint64_t bits;
+};
+
+constexpr auto mask(unsigned width) -> std::uint64_t
+{
+  return width == 64 ? ~std::uint64_t {0} : (std::uint64_t {1} << width) - 1;
+}
+
+constexpr auto sign_extend(std::uint64_t bits, unsigned width) -> std::int64_t
+{
+  auto const unused = 64 - width;
+  return static_cast<std::int64_t>(bits << unused) >> unused;
+}
+
+// Widths mirror the inference of unsigned_integer and signed_integer literals
+constexpr auto unsigned_width(std::uint64_t value) -> unsigned
+{
+  if (value <= UINT8_MAX) {
+    return 8;
+  }
+  if (value <= UINT16_MAX) {
+    return 16;
+  }
+  if (value <= UINT32_MAX) {
+    return 32;
+  }
+  return 64;
+}
+
+constexpr auto signed_width(std::int64_t value) -> unsigned
+{
+  if (INT8_MIN <= value && value <= INT8_MAX) {
+    return 8;
+  }
+  if (INT16_MIN <= value && value <= INT16_MAX) {
+    return 16;
+  }
+  if (INT32_MIN <= value && value <= INT32_MAX) {
+    return 32;
+  }
+  return 64;
+}
+
+auto as_constant(expression const& expr) -> std::optional<integer_constant>
+{
+  if (auto const* literal = dyn_cast<unsigned_integer>(expr)) {
+    return integer_constant {
+        .is_signed = false, .width = unsigned_width(literal->value), .bits = literal->value};
+  }
+
+  if (auto const* literal = dyn_cast<signed_integer>(expr)) {
+    auto width = signed_width(literal->value);
+    return integer_constant {.is_signed = true,
+                             .width = width,
+                             .bits = static_cast<std::uint64_t>(literal->value) & mask(width)};
+  }
+
+  return std::nullopt;
+}
+
+auto as_boolean(expression const& expr) -> std::optional<bool>
+{
+  if (auto const* literal = dyn_cast<boolean>(expr)) {
+    return literal->value;
+  }
+  return std::nullopt;
+}
+
+/// Literal holding `bits` as an integer of the given type, or nullptr when a literal of that value
+/// would be inferred to a narrower type
+auto make_literal(bool is_signed, unsigned width, std::uint64_t bits) -> expression_ptr
+{
+  if (is_signed) {
+    auto value = sign_extend(bits & mask(width), width);
+    if (signed_width(value) != width) {
+      return nullptr;
+    }
+    return make_node<signed_integer>(value);
+  }
+
+  auto value = bits & mask(width);
+  if (unsigned_width(value) != width) {
+    return nullptr;
+  }
+  return make_node<unsigned_integer>(value);
+}
+
+/// Bit pattern of `lhs op rhs`, or nullopt where codegen's instruction would be undefined
+auto evaluate(binop_tag op, integer_constant lhs, integer_constant rhs)
+    -> std::optional<std::uint64_t>
+{
+  auto const width = lhs.width;
+  switch (op) {
+    case binop_tag::plus:
+      return lhs.bits + rhs.bits;
+    case binop_tag::minus:
+      return lhs.bits - rhs.bits;
+    case binop_tag::multiply:
+      return lhs.bits * rhs.bits;
+
+    // Lowered to sdiv / srem for every integer type
+    case binop_tag::divide:
+    case binop_tag::modulo: {
+      auto dividend = sign_extend(lhs.bits, width);
+      auto divisor = sign_extend(rhs.bits, width);
+      if (divisor == 0 || (divisor == -1 && lhs.bits == std::uint64_t {1} << (width - 1))) {
+        return std::nullopt;
+      }
+      return static_cast<std::uint64_t>(op == binop_tag::divide ? dividend / divisor
+                                                                : dividend % divisor);
+    }
+
+    // Lowered to shl / ashr, which yield poison for shift amounts of the full width or more
+    case binop_tag::bitshift_left_:
+      if (rhs.bits >= width) {
+        return std::nullopt;
+      }
+      return lhs.bits << rhs.bits;
+    case binop_tag::bitshift_right_:
+      if (rhs.bits >= width) {
+        return std::nullopt;
+      }
+      return static_cast<std::uint64_t>(sign_extend(lhs.bits, width) >> rhs.bits);
+
+    case binop_tag::bitand_:
+      return lhs.bits & rhs.bits;
+    case binop_tag::bitxor_:
+      return lhs.bits ^ rhs.bits;
+    case binop_tag::bitor_:
+      return lhs.bits | rhs.bits;
+
+    // `as` converts types, `pow` yields floating point values and the logical operators take
+    // booleans; none of them has an integer literal as its result
+    case binop_tag::as:
+    case binop_tag::pow:
+    case binop_tag::booland:
+    case binop_tag::boolor:
+      return std::nullopt;
+  }
+
+  return std::nullopt;
+}
+
+auto fold_binary(binary_operation const& binop) -> expression_ptr
+{
+  if (binop.op.op == binop_tag::booland || binop.op.op == binop_tag::boolor) {
+    auto lhs = as_boolean(*binop.lhs);
+    auto rhs = as_boolean(*binop.rhs);
+    if (!lhs || !rhs) {
+      return nullptr;
+    }
+    return make_node<boolean>(binop.op.op == binop_tag::booland ? (*lhs && *rhs)
+                                                                 : (*lhs || *rhs));
+  }
+
+  auto lhs = as_constant(*binop.lhs);
+  auto rhs = as_constant(*binop.rhs);
+  if (!lhs || !rhs || lhs->width != rhs->width) {
+    return nullptr;
+  }
+
+  // Shift amounts are unsigned; every other operator needs operands of the same type
+  auto const is_shift =
+      binop.op.op == binop_tag::bitshift_left_ || binop.op.op == binop_tag::bitshift_right_;
+  if (is_shift ? rhs->is_signed : lhs->is_signed != rhs->is_signed) {
+    return nullptr;
+  }
+
+  auto bits = evaluate(binop.op.op, *lhs, *rhs);
+  if (!bits) {
+    return nullptr;
+  }
+  return make_literal(lhs->is_signed, lhs->width, *bits);
+}
+
+auto fold_unary(unary_operation const& unop) -> expression_ptr
+{
+  auto operand = as_constant(*unop.rhs);
+  if (!operand) {
+    return nullptr;
+  }
+
+  switch (unop.op.op) {
+    case unop_tag::plus:
+      return make_literal(operand->is_signed, operand->width, operand->bits);
+    case unop_tag::minus:
+    case unop_tag::bitnegate:
+      // Codegen has no lowering for these, so folding them would accept programs that fail to
+      // compile unfolded; `-5` would also silently become the unsigned 251
+      return nullptr;
+  }
+
+  return nullptr;
+}
+
+auto fold_comparison(comparison const& instance) -> expression_ptr
+{
+  auto lhs = as_constant(*instance.lhs);
+  auto rhs = as_constant(*instance.rhs);
+  if (!lhs || !rhs || lhs->is_signed != rhs->is_signed) {
+    return nullptr;
+  }
+
+  auto const compare = [&](auto lhs_value, auto rhs_value) -> bool
+  {
+    switch (instance.op.op) {
+      case comparison_operator_tag::lsr:
+        return lhs_value < rhs_value;
+      case comparison_operator_tag::leq:
+        return lhs_value <= rhs_value;
+      case comparison_operator_tag::geq:
+        return lhs_value >= rhs_value;
+      case comparison_operator_tag::grt:
+        return lhs_value > rhs_value;
+      case comparison_operator_tag::eq:
+        return lhs_value == rhs_value;
+      case comparison_operator_tag::neq:
+        return lhs_value != rhs_value;
+    }
+    return false;
+  };
+
+  auto result = lhs->is_signed
+      ? compare(sign_extend(lhs->bits, lhs->width), sign_extend(rhs->bits, rhs->width))
+      : compare(lhs->bits, rhs->bits);
+  return make_node<boolean>(result);
+}
+
+class constant_folder
+{
+public:
+  auto fold(expression_ptr& slot) -> void
+  {
+    auto replacement = expression_ptr {};
+
+    // Operands are folded first, so that nested constant expressions collapse bottom-up
+    if (auto* binop = dyn_cast<binary_operation>(slot.get())) {
+      this->fold(binop->lhs);
+      this->fold(binop->rhs);
+      replacement = fold_binary(*binop);
+    } else if (auto* unop = dyn_cast<unary_operation>(slot.get())) {
+      this->fold(unop->rhs);
+      replacement = fold_unary(*unop);
+    } else if (auto* instance = dyn_cast<comparison>(slot.get())) {
+      this->fold(instance->lhs);
+      this->fold(instance->rhs);
+      replacement = fold_comparison(*instance);
+    } else if (auto* instance = dyn_cast<call>(slot.get())) {
+      for (auto&& argument : instance->arguments.arguments) {
+        this->fold(argument);
+      }
+    }
+
+    if (replacement) {
+      // Annotation runs after folding, so the literal can take over the folded node's id and with
+      // it the span diagnostics point at
+      replacement->id = slot->id;
+      slot = std::move(replacement);
+      ++this->folded;
+    }
+  }
+
+  auto fold(node& ast) -> void
+  {
+    if (auto* instance = dyn_cast<mod>(&ast)) {
+      this->fold(instance->body);
+    } else if (auto* instance = dyn_cast<expr_mod>(&ast)) {
+      for (auto&& expr : instance->body) {
+        this->fold(expr);
+      }
+    } else if (auto* instance = dyn_cast<function_def>(&ast)) {
+      this->fold(instance->body);
+    } else if (auto* instance = dyn_cast<let_assignment>(&ast)) {
+      this->fold(instance->rhs);
+    } else if (auto* instance = dyn_cast<expression_statement>(&ast)) {
+      this->fold(instance->discarded);
+    } else if (auto* instance = dyn_cast<return_>(&ast)) {
+      this->fold(instance->expr);
+    } else if (auto* instance = dyn_cast<conditional_branch>(&ast)) {
+      this->fold(instance->condition);
+      this->fold(instance->body);
+      if (instance->orelse != nullptr) {
+        this->fold(*instance->orelse);
+      }
+    } else if (auto* instance = dyn_cast<unconditional_branch>(&ast)) {
+      this->fold(instance->body);
+    } else if (auto* instance = dyn_cast<for_>(&ast)) {
+      this->fold(instance->body);
+    } else if (auto* instance = dyn_cast<while_>(&ast)) {
+      this->fold(instance->body);
+    } else if (auto* instance = dyn_cast<binary_operation>(&ast)) {
+      this->fold(instance->lhs);
+      this->fold(instance->rhs);
+    } else if (auto* instance = dyn_cast<unary_operation>(&ast)) {
+      this->fold(instance->rhs);
+    } else if (auto* instance = dyn_cast<comparison>(&ast)) {
+      this->fold(instance->lhs);
+      this->fold(instance->rhs);
+    } else if (auto* instance = dyn_cast<call>(&ast)) {
+      for (auto&& argument : instance->arguments.arguments) {
+        this->fold(argument);
+      }
+    }
+  }
+
+  auto fold(statements& body) -> void
+  {
+    for (auto&& stmt : body) {
+      this->fold(*stmt);
+    }
+  }
+
+  std::size_t folded = 0;
+};
+}  // namespace
+
+namespace bython::ast
+{
+auto fold_constants(node& root) -> std::size_t
+{
+  auto folder = constant_folder {};
+  folder.fold(root);
+  return folder.folded;
+}
+}  // namespace bython::ast
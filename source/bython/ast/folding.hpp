@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+#include "bases.hpp"
+
+namespace bython::ast
+{
+
+/// Replaces unary plus, binary and comparison operations on literals with the literal they
+/// evaluate to, following the semantics codegen gives each operator. An operation is only folded
+/// when the resulting literal infers to the same type as the operation did, so type checking and
+/// codegen of the surrounding tree see no difference. `root` itself is never replaced.
+///
+/// Returns the number of operations folded.
+auto fold_constants(node& root) -> std::size_t;
+
+}  // namespace bython::ast
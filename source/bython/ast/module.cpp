@@ -12,14 +12,14 @@ auto mod::tag() const -> ast::tag
   return ast::tag {tag::mod};
 }
 
-expr_mod::expr_mod(std::vector<std::unique_ptr<ast::expression>> body_)
+expr_mod::expr_mod(ast::expressions body_)
     : body {std::move(body_)}
 {
 }
 
 auto expr_mod::tag() const -> ast::tag
 {
-  return ast::tag {tag::mod};
+  return ast::tag {tag::expr_mod};
 }
 
 }  // namespace bython::ast
\ No newline at end of file
@@ -15,15 +15,25 @@ struct mod final : node
   ast::statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::mod;
+  }
 };
 
 struct expr_mod final : node
 {
-  explicit expr_mod(std::vector<std::unique_ptr<ast::expression>> body_);
+  explicit expr_mod(ast::expressions body_);
 
-  std::vector<std::unique_ptr<ast::expression>> body;
+  ast::expressions body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::expr_mod;
+  }
 };
 
 }  // namespace bython::ast
\ No newline at end of file
@@ -20,6 +20,11 @@ struct unary_operator final : node
   unop_tag op;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::unary_operator;
+  }
 };
 
 enum class binop_tag : std::uint8_t
@@ -69,6 +74,11 @@ struct binary_operator final : node
   binop_tag op;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::binary_operator;
+  }
 };
 
 enum class comparison_operator_tag : std::uint8_t
@@ -94,6 +104,11 @@ struct comparison_operator final : node
   comparison_operator_tag op;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::comparison_operator;
+  }
 };
 
 }  // namespace bython::ast
\ No newline at end of file
@@ -2,11 +2,11 @@
 
 namespace bython::ast
 {
-let_assignment::let_assignment(std::string lhs_,
-                               std::string hint_,
-                               std::unique_ptr<expression> rhs_)
-    : lhs {std::move(lhs_)}
-    , hint {std::move(hint_)}
+let_assignment::let_assignment(symbol lhs_,
+                               symbol hint_,
+                               expression_ptr rhs_)
+    : lhs {lhs_}
+    , hint {hint_}
     , rhs {std::move(rhs_)}
 {
 }
@@ -16,8 +16,8 @@ auto let_assignment::tag() const -> ast::tag
   return ast::tag {tag::let_assignment};
 }
 
-type_definition::type_definition(std::string identifier_, bython::ast::type_definition_stmts body_)
-    : identifier {std::move(identifier_)}
+type_definition::type_definition(symbol identifier_, bython::ast::type_definition_stmts body_)
+    : identifier {identifier_}
     , body {std::move(body_)}
 {
 }
@@ -27,7 +27,7 @@ auto type_definition::tag() const -> ast::tag
   return ast::tag {tag::type_definition};
 }
 
-expression_statement::expression_statement(std::unique_ptr<expression> discarded_)
+expression_statement::expression_statement(expression_ptr discarded_)
     : discarded {std::move(discarded_)}
 {
 }
@@ -57,16 +57,16 @@ auto while_::tag() const -> ast::tag
   return ast::tag {tag::while_};
 }
 
-conditional_branch::conditional_branch(std::unique_ptr<expression> condition_, statements body_)
+conditional_branch::conditional_branch(expression_ptr condition_, statements body_)
     : condition {std::move(condition_)}
     , orelse {nullptr}
     , body {std::move(body_)}
 {
 }
 
-conditional_branch::conditional_branch(std::unique_ptr<expression> condition_,
+conditional_branch::conditional_branch(expression_ptr condition_,
                                        statements body_,
-                                       std::unique_ptr<statement> orelse_)
+                                       statement_ptr orelse_)
     : condition {std::move(condition_)}
     , orelse {std::move(orelse_)}
     , body {std::move(body_)}
@@ -88,9 +88,9 @@ auto unconditional_branch::tag() const -> ast::tag
   return ast::tag {tag::unconditional_branch};
 }
 
-parameter::parameter(std::string name_, std::string hint_)
-    : name {std::move(name_)}
-    , hint {std::move(hint_)}
+parameter::parameter(symbol name_, symbol hint_)
+    : name {name_}
+    , hint {hint_}
 {
 }
 
@@ -109,12 +109,12 @@ auto parameter_list::tag() const -> ast::tag
   return ast::tag {tag::parameter_list};
 }
 
-signature::signature(std::string name_,
+signature::signature(symbol name_,
                      parameter_list parameters_,
-                     std::optional<std::string> rettype_)
-    : name {std::move(name_)}
+                     std::optional<symbol> rettype_)
+    : name {name_}
     , parameters {std::move(parameters_)}
-    , rettype {std::move(rettype_)}
+    , rettype {rettype_}
 {
 }
 
@@ -129,7 +129,7 @@ auto function_def::tag() const -> ast::tag
   return ast::tag {tag::function_def};
 }
 
-return_::return_(std::unique_ptr<expression> expr_)
+return_::return_(expression_ptr expr_)
     : expr {std::move(expr_)}
 {
 }
@@ -2,7 +2,6 @@
 
 #include <memory>
 #include <optional>
-#include <string>
 #include <vector>
 
 #include "bases.hpp"
@@ -12,18 +11,23 @@ namespace bython::ast
 {
 struct statement : node
 {
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag().is_statement();
+  }
 };
 
-using statements = std::vector<std::unique_ptr<statement>>;
+using statement_ptr = node_ptr<statement>;
+using statements = std::vector<statement_ptr>;
 
 struct type_definition_stmt
 {
-  explicit type_definition_stmt(std::string identifier_)
-      : identifier {std::move(identifier_)}
+  explicit type_definition_stmt(symbol identifier_)
+      : identifier {identifier_}
   {
   }
 
-  std::string identifier;
+  symbol identifier;
 
   auto tag() const -> ast::tag;
 };
@@ -31,32 +35,47 @@ using type_definition_stmts = std::vector<type_definition_stmt>;
 
 struct type_definition final : statement
 {
-  type_definition(std::string identifier_, type_definition_stmts body_);
+  type_definition(symbol identifier_, type_definition_stmts body_);
 
-  std::string identifier;
+  symbol identifier;
   type_definition_stmts body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::type_definition;
+  }
 };
 
 struct let_assignment final : statement
 {
-  let_assignment(std::string lhs_, std::string hint_, std::unique_ptr<expression> rhs_);
+  let_assignment(symbol lhs_, symbol hint_, expression_ptr rhs_);
 
-  std::string lhs;
-  std::string hint;
-  std::unique_ptr<expression> rhs;
+  symbol lhs;
+  symbol hint;
+  expression_ptr rhs;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::let_assignment;
+  }
 };
 
 struct expression_statement final : statement
 {
-  expression_statement(std::unique_ptr<expression> discarded_);
+  expression_statement(expression_ptr discarded_);
 
-  std::unique_ptr<expression> discarded;
+  expression_ptr discarded;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::expression_statement;
+  }
 };
 
 struct for_ final : statement
@@ -66,6 +85,11 @@ struct for_ final : statement
   statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::for_;
+  }
 };
 
 struct while_ final : statement
@@ -75,21 +99,31 @@ struct while_ final : statement
   statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::while_;
+  }
 };
 
 struct conditional_branch final : statement
 {
-  conditional_branch(std::unique_ptr<expression> condition_, statements body_);
-  conditional_branch(std::unique_ptr<expression> condition_,
+  conditional_branch(expression_ptr condition_, statements body_);
+  conditional_branch(expression_ptr condition_,
                      statements body_,
-                     std::unique_ptr<statement> orelse_);
+                     statement_ptr orelse_);
 
-  std::unique_ptr<expression> condition;
-  std::unique_ptr<statement> orelse;
+  expression_ptr condition;
+  statement_ptr orelse;
 
   statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::conditional_branch;
+  }
 };
 
 struct unconditional_branch final : statement
@@ -99,16 +133,26 @@ struct unconditional_branch final : statement
   statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::unconditional_branch;
+  }
 };
 
 struct parameter final : node
 {
-  parameter(std::string name_, std::string hint_);
+  parameter(symbol name_, symbol hint_);
 
-  std::string name;
-  std::string hint;
+  symbol name;
+  symbol hint;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::parameter;
+  }
 };
 
 struct parameter_list final : node
@@ -118,15 +162,20 @@ struct parameter_list final : node
   std::vector<parameter> parameters;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::parameter_list;
+  }
 };
 
 struct signature
 {
-  signature(std::string name, parameter_list parameters, std::optional<std::string> rettype);
+  signature(symbol name, parameter_list parameters, std::optional<symbol> rettype);
 
-  std::string name;
+  symbol name;
   parameter_list parameters;
-  std::optional<std::string> rettype;
+  std::optional<symbol> rettype;
 };
 
 struct function_def final : statement
@@ -137,15 +186,25 @@ struct function_def final : statement
   statements body;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::function_def;
+  }
 };
 
 struct return_ final : statement
 {
-  explicit return_(std::unique_ptr<expression> expr_);
+  explicit return_(expression_ptr expr_);
 
-  std::unique_ptr<expression> expr;
+  expression_ptr expr;
 
   auto tag() const -> ast::tag;
+
+  static auto classof(node const* ast) -> bool
+  {
+    return ast->tag() == tag::return_;
+  }
 };
 
 }  // namespace bython::ast
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <array>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "symbol.hpp"
+
+namespace
+{
+namespace ast = bython::ast;
+
+// Must list spellings in the order of the ids in `ast::symbols`
+constexpr auto predefined = std::array<std::string_view, 17> {
+    "void", "bool", "u8", "u16", "u32", "u64", "i8", "i16", "i32", "i64", "f32", "f64",
+    "put_i64", "put_u64", "put_f32", "put_f64", "main",
+};
+
+static_assert(predefined[ast::symbols::void_.id] == "void");
+static_assert(predefined[ast::symbols::f64.id] == "f64");
+static_assert(predefined[ast::symbols::put_i64.id] == "put_i64");
+static_assert(predefined[ast::symbols::main.id] == "main");
+
+struct symbol_table
+{
+  symbol_table()
+  {
+    for (auto spelling : predefined) {
+      this->insert(spelling);
+    }
+  }
+
+  // Requires exclusive access
+  auto insert(std::string_view spelling) -> ast::symbol
+  {
+    if (auto it = this->lookup.find(spelling); it != this->lookup.end()) {
+      return it->second;
+    }
+
+    // std::deque never relocates its elements, so the views into them stay valid
+    auto const& stored = this->spellings.emplace_back(spelling);
+    auto sym = ast::symbol {static_cast<std::uint32_t>(this->spellings.size() - 1)};
+    this->lookup.emplace(stored, sym);
+    return sym;
+  }
+
+  std::shared_mutex mutex;
+  std::deque<std::string> spellings;
+  std::unordered_map<std::string_view, ast::symbol> lookup;
+};
+
+auto table() -> symbol_table&
+{
+  static auto instance = symbol_table {};
+  return instance;
+}
+}  // namespace
+
+namespace bython::ast
+{
+auto intern(std::string_view spelling) -> symbol
+{
+  auto& symbols = table();
+  {
+    auto reading = std::shared_lock {symbols.mutex};
+    if (auto it = symbols.lookup.find(spelling); it != symbols.lookup.end()) {
+      return it->second;
+    }
+  }
+
+  auto writing = std::unique_lock {symbols.mutex};
+  return symbols.insert(spelling);
+}
+
+auto spelling(symbol sym) -> std::string_view
+{
+  auto& symbols = table();
+  auto reading = std::shared_lock {symbols.mutex};
+  return symbols.spellings[sym.id];
+}
+}  // namespace bython::ast
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace bython::ast
+{
+
+/// Interned identifier. Equal spellings intern to the same symbol, so comparing and hashing
+/// identifiers never touches their characters.
+struct symbol
+{
+  std::uint32_t id;
+
+  constexpr auto operator<=>(symbol const& other) const = default;
+};
+
+/// Interns `spelling` into the process-wide symbol table; safe to call from any thread
+auto intern(std::string_view spelling) -> symbol;
+
+/// Spelling of an interned symbol, valid for the remainder of the program
+auto spelling(symbol sym) -> std::string_view;
+
+/// Symbols interned ahead of any parse, for names the compiler itself refers to
+namespace symbols
+{
+// Builtin types
+inline constexpr auto void_ = symbol {0};
+inline constexpr auto bool_ = symbol {1};
+inline constexpr auto u8 = symbol {2};
+inline constexpr auto u16 = symbol {3};
+inline constexpr auto u32 = symbol {4};
+inline constexpr auto u64 = symbol {5};
+inline constexpr auto i8 = symbol {6};
+inline constexpr auto i16 = symbol {7};
+inline constexpr auto i32 = symbol {8};
+inline constexpr auto i64 = symbol {9};
+inline constexpr auto f32 = symbol {10};
+inline constexpr auto f64 = symbol {11};
+
+// Builtin functions
+inline constexpr auto put_i64 = symbol {12};
+inline constexpr auto put_u64 = symbol {13};
+inline constexpr auto put_f32 = symbol {14};
+inline constexpr auto put_f64 = symbol {15};
+
+// Entrypoint
+inline constexpr auto main = symbol {16};
+}  // namespace symbols
+
+}  // namespace bython::ast
+
+template<>
+struct std::hash<bython::ast::symbol>
+{
+  auto operator()(bython::ast::symbol sym) const noexcept -> std::size_t
+  {
+    return std::hash<std::uint32_t> {}(sym.id);
+  }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "symbol.hpp"
+
+namespace bython::ast
+{
+
+/// Flat map keyed by symbol. Symbols are dense ids handed out by the interning table, so each
+/// symbol owns a slot in a contiguous vector and every lookup is a single indexed load.
+template<typename T>
+class symbol_map
+{
+public:
+  auto find(symbol key) const -> T const*
+  {
+    if (key.id >= this->m_slots.size() || !this->m_slots[key.id]) {
+      return nullptr;
+    }
+    return &*this->m_slots[key.id];
+  }
+
+  auto find(symbol key) -> T*
+  {
+    return const_cast<T*>(std::as_const(*this).find(key));
+  }
+
+  /// Inserts `value` unless `key` is already mapped; returns whether it was inserted
+  auto emplace(symbol key, T value) -> bool
+  {
+    auto& slot = this->slot(key);
+    if (slot) {
+      return false;
+    }
+
+    slot.emplace(std::move(value));
+    ++this->m_size;
+    return true;
+  }
+
+  auto insert_or_assign(symbol key, T value) -> T&
+  {
+    auto& slot = this->slot(key);
+    if (!slot) {
+      ++this->m_size;
+    }
+    return slot.emplace(std::move(value));
+  }
+
+  auto erase(symbol key) -> void
+  {
+    if (key.id < this->m_slots.size() && this->m_slots[key.id]) {
+      this->m_slots[key.id].reset();
+      --this->m_size;
+    }
+  }
+
+  auto size() const -> std::size_t
+  {
+    return this->m_size;
+  }
+
+private:
+  auto slot(symbol key) -> std::optional<T>&
+  {
+    if (key.id >= this->m_slots.size()) {
+      this->m_slots.resize(key.id + 1);
+    }
+    return this->m_slots[key.id];
+  }
+
+  std::vector<std::optional<T>> m_slots;
+  std::size_t m_size = 0;
+};
+
+}  // namespace bython::ast
@@ -27,6 +27,7 @@ public:
     call,
     signed_integer,
     unsigned_integer,
+    boolean,
   };
 
   enum statement : std::uint32_t
@@ -51,29 +52,49 @@ public:
     mod,
     argument_list,
     parameter,
-    parameter_list
+    parameter_list,
+    expr_mod,
   };
 
-  tag(tag::expression expression_tag)
+  constexpr tag(tag::expression expression_tag)
       : tag_ {expression_tag}
   {
   }
 
-  tag(tag::statement statement_tag)
+  constexpr tag(tag::statement statement_tag)
       : tag_ {statement_tag}
   {
   }
 
-  tag(tag::misc statement_tag)
+  constexpr tag(tag::misc statement_tag)
       : tag_ {statement_tag}
   {
   }
 
-  auto is_expression() const -> bool;
-  auto is_statement() const -> bool;
-  auto is_misc() const -> bool;
+  // Range checks are inline as they back every `classof` query
+  constexpr auto is_expression() const -> bool
+  {
+    return std::underlying_type_t<ranges>(ranges::expression) <= this->tag_
+        && this->tag_ < std::underlying_type_t<ranges>(ranges::statement);
+  }
+
+  constexpr auto is_statement() const -> bool
+  {
+    return std::underlying_type_t<ranges>(ranges::statement) <= this->tag_
+        && this->tag_ < std::underlying_type_t<ranges>(ranges::misc);
+  }
+
+  constexpr auto is_misc() const -> bool
+  {
+    return std::underlying_type_t<ranges>(ranges::misc) <= this->tag_;
+  }
+
+  constexpr auto unwrap() const -> std::uint32_t
+  {
+    return this->tag_;
+  }
 
-  auto unwrap() const -> std::uint32_t;
+  constexpr auto operator==(tag const& other) const -> bool = default;
 
 private:
   std::uint32_t tag_;
@@ -30,10 +30,11 @@ namespace bython::ast
   BYTHON_VISITOR_DIRECT(CLASS, INST, RET) \
   BYTHON_VISITOR_DELEGATE(CLASS, DELEGATE_TO, INST, RET)
 
+// The tag has already been switched on, so the downcast is unchecked
 #define BYTHON_VISITOR_DOWNCAST_AND_DISPATCH(DOWNCAST_TO, BASE, INST) \
   case tag::DOWNCAST_TO: { \
-    auto* downcast = dyn_cast<DOWNCAST_TO>(INST); \
-    BYTHON_DELEGATE(DOWNCAST_TO, *downcast) \
+    auto const& downcast = static_cast<DOWNCAST_TO const&>(INST); \
+    BYTHON_DELEGATE(DOWNCAST_TO, downcast) \
   }
 
 template<typename SubClass, typename RetTy = void>
@@ -56,6 +57,7 @@ struct visitor
 
   BYTHON_MAKE_VISITOR_METHODS(signed_integer, expression, inst, return_type)
   BYTHON_MAKE_VISITOR_METHODS(unsigned_integer, expression, inst, return_type)
+  BYTHON_MAKE_VISITOR_METHODS(boolean, expression, inst, return_type)
 
   BYTHON_VISITOR_DELEGATE(expression, node, inst, return_type)
   virtual auto visit(expression const& inst) -> return_type final
@@ -70,6 +72,7 @@ struct visitor
         BYTHON_VISITOR_DOWNCAST_AND_DISPATCH(call, expression, inst)
         BYTHON_VISITOR_DOWNCAST_AND_DISPATCH(signed_integer, expression, inst)
         BYTHON_VISITOR_DOWNCAST_AND_DISPATCH(unsigned_integer, expression, inst)
+        BYTHON_VISITOR_DOWNCAST_AND_DISPATCH(boolean, expression, inst)
     }
   }
 
@@ -113,16 +116,15 @@ struct visitor
   BYTHON_MAKE_VISITOR_METHODS(mod, node, inst, return_type)
   BYTHON_MAKE_VISITOR_METHODS(unary_operator, node, inst, return_type)
   BYTHON_MAKE_VISITOR_METHODS(binary_operator, node, inst, return_type)
+  BYTHON_MAKE_VISITOR_METHODS(comparison_operator, node, inst, return_type)
 
   // Fallthru to bottom
   virtual auto visit(node const& inst) -> return_type final
   {
     if (auto t = inst.tag(); t.is_expression()) {
-      auto* e = ast::dyn_cast<expression>(inst);
-      return this->visit(*e);
+      return this->visit(static_cast<expression const&>(inst));
     } else if (t.is_statement()) {
-      auto* s = ast::dyn_cast<statement>(inst);
-      return this->visit(*s);
+      return this->visit(static_cast<statement const&>(inst));
     } else {
       // Manually handle final entries
       switch (tag::misc {t.unwrap()}) {
@@ -130,21 +132,17 @@ struct visitor
           throw std::logic_error("Unrecognised misc tag");
         }
         case tag::unary_operator: {
-          auto* m = ast::dyn_cast<unary_operator>(inst);
-          return this->visit(*m);
+          return this->visit(static_cast<unary_operator const&>(inst));
         }
         case tag::binary_operator: {
-          auto* m = ast::dyn_cast<binary_operator>(inst);
-          return this->visit(*m);
+          return this->visit(static_cast<binary_operator const&>(inst));
         }
         case tag::comparison_operator: {
-          auto* m = ast::dyn_cast<comparison_operator>(inst);
-          return this->visit(*m);
+          return this->visit(static_cast<comparison_operator const&>(inst));
         }
 
         case tag::mod: {
-          auto* m = ast::dyn_cast<mod>(inst);
-          return this->visit(*m);
+          return this->visit(static_cast<mod const&>(inst));
         }
       }
     }
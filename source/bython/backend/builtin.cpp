@@ -1,34 +1,11 @@
-#include <iostream>
+#include <array>
 #include <ranges>
 
 #include "builtin.hpp"
 
+#include "bython/runtime/runtime.hpp"
 #include "bython/type_system/builtin.hpp"
 
-namespace builtin
-{
-auto put_u64_impl(uint64_t value) -> void
-{
-  std::cout << value;
-}
-
-auto put_i64_impl(int64_t value) -> void
-{
-  std::cout << value;
-}
-
-auto put_f32_impl(float value) -> void
-{
-  std::cout << value;
-}
-
-auto put_f64_impl(int64_t value) -> void
-{
-  std::cout << value;
-}
-
-}  // namespace builtin
-
 namespace
 {
 using namespace bython::backend;
@@ -55,7 +32,7 @@ static auto const builtin_lookup = std::array {
                        /*Params=*/ {llvm::Type::getInt64Ty(context)},
                        /*IsVarArg=*/false);
                  },
-                 .procedure_addr = std::uint64_t(builtin::put_i64_impl)},
+                 .procedure_addr = reinterpret_cast<std::uint64_t>(&::put_i64)},
 
     table_entry {.tag = ts::function_tag::put_u64,
                  .name = "put_u64",
@@ -66,7 +43,7 @@ static auto const builtin_lookup = std::array {
                        /*Params=*/ {llvm::Type::getInt64Ty(context)},
                        /*IsVarArg=*/false);
                  },
-                 .procedure_addr = std::uint64_t(builtin::put_i64_impl)},
+                 .procedure_addr = reinterpret_cast<std::uint64_t>(&::put_u64)},
 
     // void @put_f32(f32)
     table_entry {.tag = ts::function_tag::put_f32,
@@ -78,11 +55,11 @@ static auto const builtin_lookup = std::array {
                        /*Params=*/ {llvm::Type::getFloatTy(context)},
                        /*IsVarArg=*/false);
                  },
-                 .procedure_addr = std::uint64_t(builtin::put_f32_impl)},
+                 .procedure_addr = reinterpret_cast<std::uint64_t>(&::put_f32)},
 
-    // void @put_i64(i64)
+    // void @put_f64(f64)
     table_entry {.tag = ts::function_tag::put_f64,
-                 .name = "put_i64",
+                 .name = "put_f64",
                  .factory = [](llvm::LLVMContext& context) -> llvm::FunctionType*
                  {
                    return llvm::FunctionType::get(
@@ -90,7 +67,7 @@ static auto const builtin_lookup = std::array {
                        /*Params=*/ {llvm::Type::getDoubleTy(context)},
                        /*IsVarArg=*/false);
                  },
-                 .procedure_addr = std::uint64_t(builtin::put_f64_impl)},
+                 .procedure_addr = reinterpret_cast<std::uint64_t>(&::put_f64)},
 };
 }  // namespace
 
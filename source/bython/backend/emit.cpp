@@ -0,0 +1,58 @@
+#include "emit.hpp"
+
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+namespace
+{
+auto emit_machine_code(llvm::Module const& module_,
+                       llvm::TargetMachine& target_machine,
+                       llvm::raw_pwrite_stream& out,
+                       llvm::CodeGenFileType file_type) -> bool
+{
+  auto scope = llvm::TimeTraceScope {"Emit machine code", module_.getModuleIdentifier()};
+
+  // Codegen preparation rewrites IR in place; lower a copy so the caller's module is unaffected
+  auto lowered = llvm::CloneModule(module_);
+
+  auto pass_manager = llvm::legacy::PassManager {};
+  if (target_machine.addPassesToEmitFile(pass_manager, out, /*DwoOut=*/nullptr, file_type)) {
+    return false;
+  }
+
+  pass_manager.run(*lowered);
+  out.flush();
+  return true;
+}
+}  // namespace
+
+namespace bython::backend
+{
+auto emit(llvm::Module const& module_,
+          emit_kind kind,
+          llvm::TargetMachine& target_machine,
+          llvm::raw_pwrite_stream& out) -> bool
+{
+  switch (kind) {
+    case emit_kind::none:
+      return true;
+
+    case emit_kind::ir:
+      module_.print(out, nullptr);
+      out.flush();
+      return true;
+
+    case emit_kind::assembly:
+      return emit_machine_code(module_, target_machine, out, llvm::CGFT_AssemblyFile);
+
+    case emit_kind::object:
+      return emit_machine_code(module_, target_machine, out, llvm::CGFT_ObjectFile);
+  }
+  return false;
+}
+}  // namespace bython::backend
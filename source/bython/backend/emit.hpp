@@ -0,0 +1,26 @@
+#pragma once
+
+namespace llvm
+{
+class Module;
+class TargetMachine;
+class raw_pwrite_stream;
+}  // namespace llvm
+
+namespace bython::backend
+{
+enum class emit_kind
+{
+  none,
+  ir,
+  assembly,
+  object,
+};
+
+/// Writes `module_` to `out` as textual IR, or as assembly / an object file for `target_machine`.
+/// Returns false when the target cannot produce the requested kind of file.
+auto emit(llvm::Module const& module_,
+          emit_kind kind,
+          llvm::TargetMachine& target_machine,
+          llvm::raw_pwrite_stream& out) -> bool;
+}  // namespace bython::backend
@@ -1,20 +1,29 @@
+#include <algorithm>
 #include <cstddef>
+#include <exception>
 #include <iomanip>
 #include <limits>
 #include <map>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "llvm.hpp"
 
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/Interpreter.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/InstrTypes.h>
@@ -23,7 +32,13 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/Error.h>
 #include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/MemoryBufferRef.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/TargetParser/Triple.h>
 
@@ -32,11 +47,13 @@
 #include "bython/ast/expression.hpp"
 #include "bython/ast/operators.hpp"
 #include "bython/ast/statement.hpp"
+#include "bython/ast/symbol_map.hpp"
 #include "bython/ast/visitor.hpp"
 #include "bython/frontend/frontend.hpp"
 #include "bython/matching.hpp"
 #include "bython/type_system/builtin.hpp"
 #include "bython/type_system/environment.hpp"
+#include "bython/type_system/typed_ast.hpp"
 #include "stack.hpp"
 #include "typing.hpp"
 
@@ -61,17 +78,58 @@ template<typename Arg, typename... Args>
   throw std::logic_error {std::move(error)};
 }
 
+/// Global holding a binding made at the top level of a session
+auto global_name(symbol binding) -> std::string
+{
+  return "bython.global." + std::string {spelling(binding)};
+}
+
 struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 {
-  explicit codegen_visitor(llvm::Module& out_module, parser::parse_metadata const& metadata_)
+  codegen_visitor(llvm::Module& out_module,
+                  parser::parse_metadata const& metadata_,
+                  ts::environment& environment_,
+                  ts::typed_ast const& types_,
+                  symbol_map<ts::type*>* globals_ = nullptr)
       : context {out_module.getContext()}
       , builder {out_module.getContext()}
       , module_ {out_module}
       , metadata {metadata_}
-      , environment {ts::environment::initialise_with_builtins()}
+      , environment {environment_}
+      , types {types_}
+      , globals {globals_}
   {
   }
 
+  /// Lowers one input of a session. Definitions are lowered as in a file; any other statement or
+  /// expression runs in a new function `entry`, which stores a binding into a global for later
+  /// inputs to load, or prints the value of an expression. Returns whether `entry` was emitted.
+  auto visit_input(node const& input, llvm::StringRef entry) -> bool
+  {
+    if (isa<mod>(input) || isa<function_def>(input)) {
+      this->visit(input);
+      return false;
+    }
+
+    auto* function = llvm::Function::Create(
+        llvm::FunctionType::get(this->builder.getVoidTy(), /*isVarArg=*/false),
+        llvm::GlobalValue::ExternalLinkage,
+        entry,
+        this->module_);
+    this->builder.SetInsertPoint(llvm::BasicBlock::Create(this->context, "entry", function));
+
+    if (auto const* expr = dyn_cast<expression>(input)) {
+      this->print(*expr, this->visit(*expr));
+    } else if (auto const* assgn = dyn_cast<let_assignment>(input)) {
+      this->define_global(*assgn, this->visit(*assgn));
+    } else {
+      this->visit(input);
+    }
+
+    this->builder.CreateRetVoid();
+    return true;
+  }
+
   BYTHON_VISITOR_IMPL(mod, m)
   {
     for (auto&& stmt : m.body) {
@@ -82,27 +140,37 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 
   BYTHON_VISITOR_IMPL(function_def, fdef)
   {
-    auto ts_function_type = this->environment.add_new_function_type(fdef.sig);
+    // Signatures were registered by the annotation pass
+    auto ts_function_type = this->environment.lookup_symbol(fdef.sig.name);
     if (!ts_function_type) {
       log_and_throw("Unable to convert type system repr to LLVM backend");
     }
 
     auto function_type = ts_function_type.value();
-    this->environment.add_new_symbol(fdef.sig.name, function_type);
 
     auto llvm_function_type =
         llvm::cast<llvm::FunctionType>(backend::type(this->context, *function_type));
-    auto function = llvm::Function::Create(llvm_function_type,
-                                           llvm::GlobalValue::LinkageTypes::ExternalLinkage,
-                                           fdef.sig.name,
-                                           this->module_);
+
+    // Calls made before the definition was reached have already declared the function
+    auto function = this->module_.getFunction(ast::spelling(fdef.sig.name));
+    if (function == nullptr) {
+      function = llvm::Function::Create(llvm_function_type,
+                                        llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+                                        ast::spelling(fdef.sig.name),
+                                        this->module_);
+    } else if (!function->isDeclaration()) {
+      log_and_throw("Redefinition of function", ast::spelling(fdef.sig.name));
+    }
 
     auto entry_into_function = llvm::BasicBlock::Create(this->context, "entry", function);
     this->builder.SetInsertPoint(entry_into_function);
 
+    // Bindings are SSA values of this function, so they must not be visible from the next one
+    this->stack.push_new_scope();
     for (auto&& stmt : fdef.body) {
       this->visit(*stmt);
     }
+    this->stack.pop_scope();
 
     // Support implicit return
     if (llvm_function_type->getReturnType()->isVoidTy()) {
@@ -119,28 +187,30 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 
   BYTHON_VISITOR_IMPL(variable, var)
   {
-    auto storage = this->stack.get(var.identifier);
-    if (!storage) {
-      this->metadata.report_error(
-          var,
-          parser::frontend_error_report {.message =
-                                             "Failed to find storage on stack for this variable"});
+    // Bindings are immutable, so the stack holds their SSA values rather than storage to reload
+    auto value = this->stack.get(var.identifier);
+    if (!value && this->globals != nullptr) {
+      // Bindings made by earlier inputs of a session live in globals of their own modules
+      if (auto* const* global_type = this->globals->find(var.identifier)) {
+        auto* llvm_type = backend::type(this->context, **global_type);
+        auto* storage = this->module_.getOrInsertGlobal(global_name(var.identifier), llvm_type);
+        return this->builder.CreateLoad(llvm_type, storage, ast::spelling(var.identifier));
+      }
     }
 
-    auto var_type = this->environment.lookup_symbol(var.identifier);
-    if (!var_type) {
+    if (!value) {
       this->metadata.report_error(
-          var, parser::frontend_error_report {.message = "Failed to find type of this variable"});
+          var,
+          parser::frontend_error_report {.message = "Failed to find a binding for this variable"});
+      log_and_throw("Failed to find a binding for", ast::spelling(var.identifier));
     }
-    auto llvm_type = backend::type(this->context, *var_type.value());
 
-    auto* load = this->builder.CreateLoad(llvm_type, *storage, var.identifier);
-    return load;
+    return *value;
   }
 
   BYTHON_VISITOR_IMPL(signed_integer, instance)
   {
-    auto integer_type = this->environment.get_type(instance);
+    auto integer_type = this->types.type_of(instance);
     if (!integer_type) {
       log_and_throw("Unknown type for signed integer");
     }
@@ -151,7 +221,7 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 
   BYTHON_VISITOR_IMPL(unsigned_integer, instance)
   {
-    auto integer_type = this->environment.get_type(instance);
+    auto integer_type = this->types.type_of(instance);
     if (!integer_type) {
       log_and_throw("Unknown type for unsigned integer");
     }
@@ -160,13 +230,18 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
     return llvm::ConstantInt::get(llvm_type, instance.value, /*IsSigned=*/false);
   }
 
+  BYTHON_VISITOR_IMPL(boolean, instance)
+  {
+    return llvm::ConstantInt::getBool(this->context, instance.value);
+  }
+
   BYTHON_VISITOR_IMPL(let_assignment, assgn)
   {
     // Compute RHS of assignment
     auto* rhs_value = this->visit(*assgn.rhs);
 
     // Load type for RHS
-    auto rhs_type = this->environment.get_type(*assgn.rhs);
+    auto rhs_type = this->types.type_of(*assgn.rhs);
     if (!rhs_type) {
       this->metadata.report_error(
           *assgn.rhs, parser::frontend_error_report {.message = "Unable to infer for RHS"});
@@ -175,23 +250,22 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
     // Load type for LHS
     auto lhs_type = this->environment.lookup_type(assgn.hint);
     if (!lhs_type) {
-      log_and_throw("Unknown type", assgn.hint, "used on LHS of assignment");
+      log_and_throw("Unknown type", ast::spelling(assgn.hint), "used on LHS of assignment");
     }
 
     auto subtyped_rhs = this->subtype(*assgn.rhs, rhs_value, *rhs_type, *lhs_type);
-    auto allocation =
-        this->builder.CreateAlloca(subtyped_rhs->getType(), /*ArraySize=*/nullptr, assgn.lhs);
-
-    this->environment.add_new_symbol(assgn.lhs, lhs_type.value());
-    this->stack.put(assgn.lhs, allocation);
+    if (llvm::isa<llvm::Instruction>(subtyped_rhs) && !subtyped_rhs->hasName()) {
+      subtyped_rhs->setName(ast::spelling(assgn.lhs));
+    }
 
-    return this->builder.CreateStore(subtyped_rhs, allocation);
+    this->stack.put(assgn.lhs, subtyped_rhs);
+    return subtyped_rhs;
   }
 
   BYTHON_VISITOR_IMPL(binary_operation, binop)
   {
     auto lhs_v = this->visit(*binop.lhs);
-    auto lhs_type = this->environment.get_type(*binop.lhs);
+    auto lhs_type = this->types.type_of(*binop.lhs);
     if (!lhs_type) {
       log_and_throw("unknown lhs type");
     }
@@ -202,7 +276,7 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
     if (binop.op.op != ast::binop_tag::as) {
       // Visit and store type of RHS before calling "real" binary operations
       rhs_v = this->visit(*binop.rhs);
-      rhs_type = this->environment.get_type(*binop.rhs);
+      rhs_type = this->types.type_of(*binop.rhs);
     }
 
     switch (binop.op.op) {
@@ -285,7 +359,7 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
       }
       case ast::binop_tag::booland:
       case ast::binop_tag::boolor: {
-        auto b = this->environment.lookup_type("bool").value();
+        auto b = this->environment.lookup_type(ast::symbols::bool_).value();
         lhs_v = this->subtype(*binop.lhs, lhs_v, lhs_type.value(), b);
         rhs_v = this->subtype(*binop.rhs, rhs_v, rhs_type.value(), b);
 
@@ -298,19 +372,19 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 
   BYTHON_VISITOR_IMPL(call, instance)
   {
-    auto rettype = this->environment.get_type(instance);
+    auto rettype = this->types.type_of(instance);
     if (!rettype) {
-      log_and_throw("Failed to infer type for call", instance.callee);
+      log_and_throw("Failed to infer type for call", ast::spelling(instance.callee));
     }
 
     auto ft = this->environment.lookup_symbol(instance.callee);
     if (!ft) {
-      log_and_throw("Could not lookup", instance.callee);
+      log_and_throw("Could not lookup", ast::spelling(instance.callee));
     }
 
     auto ft_real = dynamic_cast<ts::function_signature*>(ft.value());
     if (ft_real == nullptr) {
-      log_and_throw("Signature of", instance.callee, "is unknown");
+      log_and_throw("Signature of", ast::spelling(instance.callee), "is unknown");
     }
 
     if (ft_real->parameters.size() != instance.arguments.arguments.size()) {
@@ -326,7 +400,7 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
       auto&& argument = instance.arguments.arguments[i];
       auto loaded = this->visit(*argument);
 
-      auto argument_type = this->environment.get_type(*argument);
+      auto argument_type = this->types.type_of(*argument);
       if (!argument_type) {
         log_and_throw("Unable to infer type of parameter");
       }
@@ -340,11 +414,12 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
       return this->builder.CreateCall(*builtin, load_arguments);
     }
 
-    if (auto defined = this->module_.getFunction(instance.callee); defined != nullptr) {
-      return this->builder.CreateCall(defined, load_arguments);
-    }
-
-    log_and_throw("Cannot call function; undefined: ", instance.callee);
+    // The callee may be defined later in this module or, when compiling in parallel, in another
+    // partition; declaring it here leaves the definition to be resolved by the linker
+    auto callee = this->module_.getOrInsertFunction(
+        ast::spelling(instance.callee),
+        llvm::cast<llvm::FunctionType>(backend::type(this->context, *ft_real)));
+    return this->builder.CreateCall(callee, load_arguments);
   }
 
   BYTHON_VISITOR_IMPL(expression_statement, instance)
@@ -373,10 +448,13 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
 
     this->builder.CreateCondBr(branch_on, if_true, otherwise);
 
+    // Values bound in the branch do not dominate the merge block
     this->builder.SetInsertPoint(if_true);
+    this->stack.push_new_scope();
     for (auto&& stmt : instance.body) {
       this->visit(*stmt);
     }
+    this->stack.pop_scope();
     this->builder.CreateBr(joined);
 
     if (instance.orelse != nullptr) {
@@ -425,12 +503,12 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
     auto lhs = this->visit(*instance.lhs);
     auto rhs = this->visit(*instance.rhs);
 
-    auto lhs_t = this->environment.get_type(*instance.lhs);
+    auto lhs_t = this->types.type_of(*instance.lhs);
     if (!lhs_t) {
       log_and_throw("comp lhs infer failed");
     }
 
-    auto rhs_t = this->environment.get_type(*instance.rhs);
+    auto rhs_t = this->types.type_of(*instance.rhs);
     if (!rhs_t) {
       log_and_throw("comp rhs infer failed");
     }
@@ -472,25 +550,77 @@ struct codegen_visitor final : visitor<codegen_visitor, llvm::Value*>
   }
 
 private:
-  auto insert_or_retrieve_builtin(std::string_view builtin_name)
+  auto define_global(let_assignment const& assgn, llvm::Value* value) -> void
+  {
+    auto binding_type = this->environment.lookup_type(assgn.hint);
+    if (!binding_type || this->globals == nullptr) {
+      log_and_throw("Unable to define", ast::spelling(assgn.lhs), "at the top level");
+    }
+
+    auto* storage = new llvm::GlobalVariable(this->module_,
+                                             value->getType(),
+                                             /*isConstant=*/false,
+                                             llvm::GlobalValue::ExternalLinkage,
+                                             llvm::Constant::getNullValue(value->getType()),
+                                             global_name(assgn.lhs));
+    this->builder.CreateStore(value, storage);
+    this->globals->insert_or_assign(assgn.lhs, *binding_type);
+  }
+
+  // Prints `value` with the put_* builtin matching the type of `expr`; void values print nothing
+  auto print(expression const& expr, llvm::Value* value) -> void
+  {
+    auto expr_type = this->types.type_of(expr);
+    if (!expr_type) {
+      log_and_throw("Unable to infer the type of the expression to print");
+    }
+
+    auto builtin = ts::function_tag {};
+    switch (expr_type.value()->tag()) {
+      case ts::type_tag::boolean:
+      case ts::type_tag::uint:
+        value = this->builder.CreateZExt(value, this->builder.getInt64Ty());
+        builtin = ts::function_tag::put_u64;
+        break;
+      case ts::type_tag::sint:
+        value = this->builder.CreateSExt(value, this->builder.getInt64Ty());
+        builtin = ts::function_tag::put_i64;
+        break;
+      case ts::type_tag::single_fp:
+        builtin = ts::function_tag::put_f32;
+        break;
+      case ts::type_tag::double_fp:
+        builtin = ts::function_tag::put_f64;
+        break;
+      case ts::type_tag::void_:
+      case ts::type_tag::function:
+        return;
+    }
+
+    auto callee = backend::builtin_function(this->context, builtin);
+    this->builder.CreateCall(this->module_.getOrInsertFunction(callee.name, callee.signature),
+                             {value});
+  }
+
+  auto insert_or_retrieve_builtin(ast::symbol builtin_name)
       -> std::optional<llvm::FunctionCallee>
   {
-    if (builtin_name == "put_i64") {
+    if (builtin_name == ast::symbols::put_i64) {
       auto put_i64 = backend::builtin_function(this->context, ts::function_tag::put_i64);
       return this->module_.getOrInsertFunction(put_i64.name, put_i64.signature);
     }
 
-    if (builtin_name == "put_u64") {
+    if (builtin_name == ast::symbols::put_u64) {
       auto put_u64 = backend::builtin_function(this->context, ts::function_tag::put_u64);
       return this->module_.getOrInsertFunction(put_u64.name, put_u64.signature);
     }
 
-    if (builtin_name == "put_f32") {
+    if (builtin_name == ast::symbols::put_f32) {
       auto put_f32 = backend::builtin_function(this->context, ts::function_tag::put_f32);
       return this->module_.getOrInsertFunction(put_f32.name, put_f32.signature);
     }
 
-    if (builtin_name == "put_f64") {
+    if (builtin_name == ast::symbols::put_f64) {
       auto put_f64 = backend::builtin_function(this->context, ts::function_tag::put_f64);
       return this->module_.getOrInsertFunction(put_f64.name, put_f64.signature);
     }
@@ -507,6 +637,7 @@ private:
     if (!subtyping_rule) {
       this->metadata.report_error(
           node, parser::frontend_error_report {.message = "Invalid conversion here!"});
+      log_and_throw("Invalid conversion");
     }
 
     auto subtype_mapper = backend::subtype_conversion(subtyping_rule.value());
@@ -518,33 +649,276 @@ private:
   llvm::Module& module_;
 
   parser::parse_metadata const& metadata;
-  type_system::environment environment;
+  type_system::environment& environment;
+  type_system::typed_ast const& types;
   backend::stack stack;
 
+  // Types of the bindings made at the top level of a session; null when compiling a file
+  symbol_map<ts::type*>* globals;
+
 };  // namespace bython
 
 }  // namespace bython
 
+namespace bython
+{
+namespace
+{
+using bitcode = llvm::SmallVector<char, 0>;
+
+/// Generates code for the top-level statements in [first, last) into a module of its own context,
+/// returned as bitcode so it can be carried over into another context
+auto compile_partition(std::string_view name,
+                       statements::const_iterator first,
+                       statements::const_iterator last,
+                       parser::parse_metadata const& metadata,
+                       ts::environment& environment,
+                       ts::typed_ast const& types) -> bitcode
+{
+  auto context = llvm::LLVMContext {};
+  auto partition = llvm::Module {name, context};
+
+  auto visitor = codegen_visitor {partition, metadata, environment, types};
+  for (; first != last; ++first) {
+    visitor.visit(**first);
+  }
+
+  auto buffer = bitcode {};
+  auto out = llvm::raw_svector_ostream {buffer};
+  llvm::WriteBitcodeToFile(partition, out);
+  return buffer;
+}
+
+/// Splits the module's body into one contiguous partition per thread and links the partitions
+/// back together in order, so the result does not depend on scheduling
+auto compile_in_parallel(mod const& module_ast,
+                         parser::parse_metadata const& metadata,
+                         ts::environment& environment,
+                         ts::typed_ast const& types,
+                         llvm::Module& module_,
+                         unsigned threads) -> void
+{
+  auto const& body = module_ast.body;
+  auto partitions = std::min<std::size_t>(threads, body.size());
+  auto name = module_.getModuleIdentifier();
+
+  auto compiled = std::vector<bitcode>(partitions);
+  auto errors = std::vector<std::exception_ptr>(partitions);
+  {
+    // Codegen only reads the environment and the annotations, so partitions can share them
+    auto pool = llvm::ThreadPool {llvm::hardware_concurrency(threads)};
+    for (auto i = std::size_t {0}; i < partitions; ++i) {
+      auto first = body.begin() + static_cast<std::ptrdiff_t>(i * body.size() / partitions);
+      auto last = body.begin() + static_cast<std::ptrdiff_t>((i + 1) * body.size() / partitions);
+      // The pool does not carry exceptions across threads, so a throwing task would terminate
+      pool.async(
+          [&, i, first, last]
+          {
+            try {
+              compiled[i] = compile_partition(name, first, last, metadata, environment, types);
+            } catch (...) {
+              errors[i] = std::current_exception();
+            }
+          });
+    }
+    pool.wait();
+  }
+
+  // Codegen errors are rethrown on the calling thread, in partition order
+  for (auto&& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  auto scope = llvm::TimeTraceScope {"Link partitions", name};
+  for (auto&& partition : compiled) {
+    auto parsed = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef {llvm::StringRef {partition.data(), partition.size()}, name},
+        module_.getContext());
+    if (!parsed) {
+      log_and_throw("Failed to read back a partition of", name, llvm::toString(parsed.takeError()));
+    }
+
+    if (llvm::Linker::linkModules(module_, std::move(*parsed))) {
+      log_and_throw("Failed to link a partition of", name);
+    }
+  }
+}
+}  // namespace
+}  // namespace bython
+
 namespace bython::backend
 {
 auto compile(std::string_view name,
-             std::unique_ptr<node> ast,
+             node const& ast,
              parser::parse_metadata const& metadata,
-             llvm::LLVMContext& context) -> std::unique_ptr<llvm::Module>
+             llvm::LLVMContext& context,
+             unsigned threads) -> std::unique_ptr<llvm::Module>
 {
   auto module_ = std::make_unique<llvm::Module>(name, context);
-  compile(std::move(ast), metadata, *module_);
+  compile(ast, metadata, *module_, threads);
 
   return module_;
 }
 
-auto compile(std::unique_ptr<node> ast,
+auto compile(node const& ast,
              parser::parse_metadata const& metadata,
-             llvm::Module& module_) -> void
+             llvm::Module& module_,
+             unsigned threads) -> void
 {
-  auto visitor = codegen_visitor {module_, metadata};
-  visitor.visit(*ast);
+  // Type checking registers bindings in program order, so it stays a single sequential pass
+  auto environment = ts::environment::initialise_with_builtins();
+  auto types = [&]
+  {
+    auto scope = llvm::TimeTraceScope {"Type inference"};
+    return environment.annotate(ast);
+  }();
+
+  auto scope = llvm::TimeTraceScope {"Codegen", module_.getModuleIdentifier()};
+  if (auto const* module_ast = dyn_cast<mod>(ast); module_ast != nullptr && threads > 1) {
+    compile_in_parallel(*module_ast, metadata, environment, types, module_, threads);
+  } else {
+    auto visitor = codegen_visitor {module_, metadata, environment, types};
+    visitor.visit(ast);
+  }
 
   llvm::verifyModule(module_, &llvm::errs());
 }
-}  // namespace bython::backend
\ No newline at end of file
+}  // namespace bython::backend
+
+namespace bython::backend
+{
+struct session::session_pimpl
+{
+  /// Whether `input` can be compiled on top of the earlier inputs. Inference registers a binding
+  /// only once and reports nothing when it fails, so both are checked up front.
+  auto accepts(node const& input, parser::parse_metadata const& metadata) const -> bool
+  {
+    auto reject = [&](node const& offending, std::string message)
+    {
+      metadata.report_error(offending,
+                            parser::frontend_error_report {.message = std::move(message)});
+      return false;
+    };
+
+    auto unbound = [&](node const& offending, symbol name)
+    {
+      return !this->environment.lookup_symbol(name)
+          || reject(offending, "'" + std::string {spelling(name)} + "' is already defined");
+    };
+
+    auto typed = [&](expression const& expr)
+    {
+      return this->environment.get_type(expr).has_value()
+          || reject(expr, "Unable to infer the type of this expression");
+    };
+
+    if (auto const* module_ast = dyn_cast<mod>(input)) {
+      return std::ranges::all_of(module_ast->body,
+                                 [&](auto const& stmt)
+                                 {
+                                   auto const* fdef = dyn_cast<function_def>(stmt.get());
+                                   return fdef == nullptr || unbound(*fdef, fdef->sig.name);
+                                 });
+    }
+    if (auto const* fdef = dyn_cast<function_def>(input)) {
+      return unbound(*fdef, fdef->sig.name);
+    }
+    if (auto const* assgn = dyn_cast<let_assignment>(input)) {
+      auto hint = "'" + std::string {spelling(assgn->hint)} + "'";
+      auto binding_type = this->environment.lookup_type(assgn->hint);
+      if (!binding_type) {
+        return reject(*assgn, "Unknown type " + hint);
+      }
+      if (!unbound(*assgn, assgn->lhs) || !typed(*assgn->rhs)) {
+        return false;
+      }
+
+      auto rhs_type = this->environment.get_type(*assgn->rhs);
+      return this->environment.try_subtype(**rhs_type, **binding_type).has_value()
+          || reject(*assgn->rhs, "Cannot convert this to " + hint);
+    }
+    if (auto const* discard = dyn_cast<expression_statement>(input)) {
+      return typed(*discard->discarded);
+    }
+    if (isa<return_>(input)) {
+      return reject(input, "Cannot return outside of a function");
+    }
+    if (auto const* expr = dyn_cast<expression>(input)) {
+      return typed(*expr);
+    }
+    return true;
+  }
+
+  ts::environment environment = ts::environment::initialise_with_builtins();
+  symbol_map<ts::type*> globals;
+  std::size_t inputs = 0;
+
+  // Symbols of the environment before the pending input was annotated, and the globals including
+  // those the pending input defines
+  std::optional<symbol_map<ts::type*>> committed_symbols;
+  symbol_map<ts::type*> pending_globals;
+};
+
+session::session()
+    : impl {std::make_unique<session_pimpl>()}
+{
+}
+
+session::~session() = default;
+
+session::session(session&&) noexcept = default;
+auto session::operator=(session&&) noexcept -> session& = default;
+
+auto session::compile(node const& input,
+                      parser::parse_metadata const& metadata,
+                      llvm::LLVMContext& context) -> std::optional<compiled_input>
+{
+  this->rollback();
+  if (!this->impl->accepts(input, metadata)) {
+    return std::nullopt;
+  }
+
+  // Annotation registers the input's names right away, so they are undone if it fails to compile
+  this->impl->committed_symbols = this->impl->environment.symbols();
+  this->impl->pending_globals = this->impl->globals;
+  auto types = this->impl->environment.annotate(input);
+
+  auto index = std::to_string(this->impl->inputs++);
+  auto result = compiled_input {std::make_unique<llvm::Module>("input." + index, context), ""};
+  try {
+    auto visitor = codegen_visitor {
+        *result.module_, metadata, this->impl->environment, types, &this->impl->pending_globals};
+    if (auto entry = "bython.input." + index; visitor.visit_input(input, entry)) {
+      result.entry = std::move(entry);
+    }
+  } catch (std::logic_error const&) {
+    // Codegen has already logged why it gave up
+    this->rollback();
+    return std::nullopt;
+  }
+
+  if (llvm::verifyModule(*result.module_, &llvm::errs())) {
+    this->rollback();
+    return std::nullopt;
+  }
+  return result;
+}
+
+auto session::commit() -> void
+{
+  if (this->impl->committed_symbols) {
+    this->impl->globals = std::move(this->impl->pending_globals);
+    this->impl->committed_symbols.reset();
+  }
+}
+
+auto session::rollback() -> void
+{
+  if (this->impl->committed_symbols) {
+    this->impl->environment.restore_symbols(std::move(*this->impl->committed_symbols));
+    this->impl->committed_symbols.reset();
+  }
+}
+}  // namespace bython::backend
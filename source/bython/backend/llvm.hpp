@@ -1,17 +1,67 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <string>
+
 #include <bython/ast/bases.hpp>
 #include <bython/frontend/frontend.hpp>
 #include <llvm/IR/Module.h>
 
 namespace bython::backend
 {
+/// Type checks `ast` and lowers it into `module_`. With more than one thread, the functions of a
+/// module are generated concurrently in separate contexts and linked back into `module_`.
 auto compile(std::string_view name,
-             std::unique_ptr<ast::node> ast,
+             ast::node const& ast,
              parser::parse_metadata const& metadata,
-             llvm::LLVMContext& context) -> std::unique_ptr<llvm::Module>;
+             llvm::LLVMContext& context,
+             unsigned threads = 1) -> std::unique_ptr<llvm::Module>;
 
-auto compile(std::unique_ptr<ast::node> ast,
+auto compile(ast::node const& ast,
              parser::parse_metadata const& metadata,
-             llvm::Module& module_) -> void;
+             llvm::Module& module_,
+             unsigned threads = 1) -> void;
+
+/// Module lowered from one input of a session
+struct compiled_input
+{
+  std::unique_ptr<llvm::Module> module_;
+  // Function to run for the input's effects, or empty when it only defines functions
+  std::string entry;
+};
+
+/// Compiles a program one input at a time, such as the lines entered into a REPL. Functions and
+/// bindings of earlier inputs stay visible to later ones: bindings are kept in globals, since
+/// every input is lowered into a module of its own.
+struct session
+{
+  session();
+  ~session();
+
+  session(session const&) = delete;
+  auto operator=(session const&) noexcept -> session& = delete;
+
+  session(session&&) noexcept;
+  auto operator=(session&&) noexcept -> session&;
+
+  /// Type checks and lowers a module, statement or expression. Statements other than function
+  /// definitions run in the entry function, and expressions also print their value. Errors are
+  /// reported through `metadata` and yield nullopt.
+  ///
+  /// The names the input defines stay pending until `commit`; compiling another input first, or
+  /// calling `rollback`, forgets them again.
+  auto compile(ast::node const& input,
+               parser::parse_metadata const& metadata,
+               llvm::LLVMContext& context) -> std::optional<compiled_input>;
+
+  /// Makes the names defined by the last compiled input visible to later ones, once its module
+  /// has been loaded and its entry has run
+  auto commit() -> void;
+  auto rollback() -> void;
+
+private:
+  struct session_pimpl;
+  std::unique_ptr<session_pimpl> impl;
+};
 }  // namespace bython::backend
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include <optional>
+
+#include "optimise.hpp"
+
+#include <llvm/Analysis/CGSCCPassManager.h>
+#include <llvm/Analysis/LoopAnalysisManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/StandardInstrumentations.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Target/TargetMachine.h>
+
+namespace
+{
+namespace b = bython::backend;
+
+auto to_llvm(b::optimisation_level level) -> llvm::OptimizationLevel
+{
+  switch (level) {
+    case b::optimisation_level::O0:
+      return llvm::OptimizationLevel::O0;
+    case b::optimisation_level::O1:
+      return llvm::OptimizationLevel::O1;
+    case b::optimisation_level::O2:
+      return llvm::OptimizationLevel::O2;
+    case b::optimisation_level::O3:
+      return llvm::OptimizationLevel::O3;
+    case b::optimisation_level::Os:
+      return llvm::OptimizationLevel::Os;
+  }
+  return llvm::OptimizationLevel::O0;
+}
+}  // namespace
+
+namespace bython::backend
+{
+auto optimise(llvm::Module& module_,
+              optimisation_level level,
+              llvm::TargetMachine* target_machine) -> void
+{
+  // Codegen already produces verified IR; O0 keeps it exactly as emitted
+  if (level == optimisation_level::O0) {
+    return;
+  }
+
+  auto scope = llvm::TimeTraceScope {"Optimise", module_.getModuleIdentifier()};
+
+  auto lam = llvm::LoopAnalysisManager {};
+  auto fam = llvm::FunctionAnalysisManager {};
+  auto cgam = llvm::CGSCCAnalysisManager {};
+  auto mam = llvm::ModuleAnalysisManager {};
+
+  // While tracing, every pass is reported as a scope nested in the one above
+  auto callbacks = llvm::PassInstrumentationCallbacks {};
+  auto instrumentation = std::optional<llvm::StandardInstrumentations> {};
+  if (llvm::timeTraceProfilerEnabled()) {
+    instrumentation.emplace(module_.getContext(), /*DebugLogging=*/false);
+    instrumentation->registerCallbacks(callbacks, &mam);
+  }
+
+  auto builder =
+      llvm::PassBuilder {target_machine, llvm::PipelineTuningOptions {}, std::nullopt, &callbacks};
+  builder.registerModuleAnalyses(mam);
+  builder.registerCGSCCAnalyses(cgam);
+  builder.registerFunctionAnalyses(fam);
+  builder.registerLoopAnalyses(lam);
+  builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+  auto pipeline = builder.buildPerModuleDefaultPipeline(to_llvm(level));
+  pipeline.run(module_, mam);
+}
+}  // namespace bython::backend
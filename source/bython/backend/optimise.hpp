@@ -0,0 +1,25 @@
+#pragma once
+
+namespace llvm
+{
+class Module;
+class TargetMachine;
+}  // namespace llvm
+
+namespace bython::backend
+{
+enum class optimisation_level
+{
+  O0,
+  O1,
+  O2,
+  O3,
+  Os,
+};
+
+/// Runs LLVM's default per-module pipeline for `level` over `module_`.
+/// When given, `target_machine` supplies the target's cost model to the passes.
+auto optimise(llvm::Module& module_,
+              optimisation_level level,
+              llvm::TargetMachine* target_machine = nullptr) -> void;
+}  // namespace bython::backend
@@ -1,5 +1,4 @@
-#include <ranges>
-#include <unordered_map>
+#include <vector>
 
 #include "stack.hpp"
 
@@ -10,33 +9,47 @@ namespace bython::backend
 
 stack::stack()
 {
-  this->lookup.emplace_back();
+  this->scopes.emplace_back();
 }
 
-auto stack::get(std::string_view symbol_name) const -> std::optional<llvm::Value*>
+auto stack::get(ast::symbol symbol_name) const -> std::optional<llvm::Value*>
 {
-  for (auto&& it : std::ranges::reverse_view(this->lookup)) {
-    if (auto search = it.find(symbol_name); search != it.end()) {
-      return search->second;
-    }
+  if (auto const* chain = this->bindings.find(symbol_name); chain != nullptr && !chain->empty()) {
+    return chain->back().value;
   }
 
   return std::nullopt;
 }
 
-auto stack::put(std::string symbol_name, llvm::Value* symbol_storage_loc) -> void
+auto stack::put(ast::symbol symbol_name, llvm::Value* symbol_value) -> void
 {
-  this->lookup.back().insert_or_assign(symbol_name, symbol_storage_loc);
+  auto depth = this->scopes.size();
+  auto* chain = this->bindings.find(symbol_name);
+  if (chain == nullptr) {
+    chain = &this->bindings.insert_or_assign(symbol_name, {});
+  }
+
+  // Rebinding within the same scope replaces the binding rather than shadowing it
+  if (!chain->empty() && chain->back().depth == depth) {
+    chain->back().value = symbol_value;
+    return;
+  }
+
+  chain->push_back(binding {.value = symbol_value, .depth = depth});
+  this->scopes.back().push_back(symbol_name);
 }
 
 auto stack::push_new_scope() -> void
 {
-  this->lookup.emplace_back();
+  this->scopes.emplace_back();
 }
 
 auto stack::pop_scope() -> void
 {
-  this->lookup.pop_back();
+  for (auto symbol_name : this->scopes.back()) {
+    this->bindings.find(symbol_name)->pop_back();
+  }
+  this->scopes.pop_back();
 }
 
-}  // namespace bython::backend
\ No newline at end of file
+}  // namespace bython::backend
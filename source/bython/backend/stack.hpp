@@ -1,30 +1,41 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
 #include <optional>
 #include <vector>
 
-#include <llvm-16/llvm/IR/Value.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include "bython/ast/symbol.hpp"
+#include "bython/ast/symbol_map.hpp"
+
 namespace bython::backend
 {
 
+/// Scope chain of the values bound to each symbol. Every symbol maps to its own stack of
+/// bindings, innermost last, so looking a symbol up is a single probe regardless of nesting depth.
 class stack
 {
-  using mapping = std::map<std::string, llvm::Value*, std::less<>>;
+  struct binding
+  {
+    llvm::Value* value;
+    std::size_t depth;
+  };
 
 public:
   stack();
 
-  auto get(std::string_view identifier) const -> std::optional<llvm::Value*>;
-  auto put(std::string symbol_name, llvm::Value* symbol_storage_loc) -> void;
+  auto get(ast::symbol identifier) const -> std::optional<llvm::Value*>;
+  auto put(ast::symbol symbol_name, llvm::Value* symbol_value) -> void;
 
   auto push_new_scope() -> void;
   auto pop_scope() -> void;
 
 private:
-  std::vector<mapping> lookup;
+  ast::symbol_map<std::vector<binding>> bindings;
+
+  // Symbols bound in each open scope, so that popping a scope only touches its own bindings
+  std::vector<std::vector<ast::symbol>> scopes;
 };
-}  // namespace bython::backend
\ No newline at end of file
+}  // namespace bython::backend
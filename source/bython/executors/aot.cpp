@@ -0,0 +1,225 @@
+#include <array>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
+
+#include "aot.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "bython/backend/emit.hpp"
+#include "bython/backend/optimise.hpp"
+#include "pipeline.hpp"
+
+#ifndef BYTHON_LINKER
+#  define BYTHON_LINKER "c++"
+#endif
+
+#ifndef BYTHON_RUNTIME_LIBRARY
+#  define BYTHON_RUNTIME_LIBRARY "libbython_runtime.a"
+#endif
+
+#ifndef BYTHON_RUNTIME_LIBRARY_NAME
+#  define BYTHON_RUNTIME_LIBRARY_NAME "libbython_runtime.a"
+#endif
+
+namespace
+{
+// Executables are entered through the C runtime's `int main()`, so the program's own `main` is
+// renamed and called from a generated entry point
+auto add_entry_point(llvm::Module& module_) -> bool
+{
+  auto* program_main = module_.getFunction("main");
+  if (program_main == nullptr || program_main->arg_size() != 0) {
+    std::cerr << "Cannot find main function! Exiting...\n";
+    return false;
+  }
+
+  program_main->setName("bython.main");
+  program_main->setLinkage(llvm::GlobalValue::InternalLinkage);
+
+  auto& context = module_.getContext();
+  auto* entry_type = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), /*isVarArg=*/false);
+  auto* entry =
+      llvm::Function::Create(entry_type, llvm::GlobalValue::ExternalLinkage, "main", module_);
+
+  auto builder = llvm::IRBuilder<> {llvm::BasicBlock::Create(context, "entry", entry)};
+  builder.CreateCall(program_main);
+
+  // Write out whatever the runtime still holds before handing control back to the C runtime
+  auto flush = module_.getOrInsertFunction(
+      "bython_flush", llvm::FunctionType::get(builder.getVoidTy(), /*isVarArg=*/false));
+  builder.CreateCall(flush);
+  builder.CreateRet(builder.getInt32(0));
+  return true;
+}
+
+/// `requested` when given; otherwise the compiler the driver was built with, or the compiler of
+/// that name on PATH when the build's absolute path does not exist on this machine
+auto find_linker(std::string const& requested) -> std::optional<std::string>
+{
+  if (!requested.empty()) {
+    if (auto linker = llvm::sys::findProgramByName(requested)) {
+      return *linker;
+    }
+    return std::nullopt;
+  }
+
+  if (auto linker = llvm::sys::findProgramByName(BYTHON_LINKER)) {
+    return *linker;
+  }
+  auto name = std::filesystem::path {BYTHON_LINKER}.filename().string();
+  if (auto linker = llvm::sys::findProgramByName(name)) {
+    return *linker;
+  }
+  return std::nullopt;
+}
+
+/// `requested` when given; otherwise the runtime archive in `<prefix>/lib` of an installed driver,
+/// falling back to the one in the build tree so that the driver also works uninstalled
+auto find_runtime_library(std::filesystem::path const& requested)
+    -> std::optional<std::filesystem::path>
+{
+  if (!requested.empty()) {
+    return std::filesystem::exists(requested) ? std::optional {requested} : std::nullopt;
+  }
+
+  auto anchor = reinterpret_cast<void*>(&find_runtime_library);
+  auto executable = llvm::sys::fs::getMainExecutable(nullptr, anchor);
+  if (!executable.empty()) {
+    auto installed = std::filesystem::path {executable}.parent_path().parent_path() / "lib"
+        / BYTHON_RUNTIME_LIBRARY_NAME;
+    if (std::filesystem::exists(installed)) {
+      return installed;
+    }
+  }
+
+  if (std::filesystem::exists(BYTHON_RUNTIME_LIBRARY)) {
+    return BYTHON_RUNTIME_LIBRARY;
+  }
+  return std::nullopt;
+}
+
+auto link_executable(std::string const& object_file,
+                     std::string const& output_file,
+                     bython::executor::aot_options const& options) -> bool
+{
+  auto scope = llvm::TimeTraceScope {"Link", output_file};
+
+  auto linker = find_linker(options.linker);
+  if (!linker) {
+    std::cerr << "Unable to find the linker driver "
+              << (options.linker.empty() ? BYTHON_LINKER : options.linker) << "\n";
+    return false;
+  }
+
+  auto runtime_library = find_runtime_library(options.runtime_library);
+  if (!runtime_library) {
+    auto missing = options.runtime_library.empty()
+        ? std::filesystem::path {BYTHON_RUNTIME_LIBRARY_NAME}
+        : options.runtime_library;
+    std::cerr << "Unable to find " << missing << "; pass its location with --runtime-library\n";
+    return false;
+  }
+
+  auto runtime_path = runtime_library->string();
+  auto arguments = std::array<llvm::StringRef, 5> {
+      *linker, object_file, runtime_path, "-o", output_file};
+
+  auto message = std::string {};
+  auto status = llvm::sys::ExecuteAndWait(*linker,
+                                          arguments,
+                                          /*Env=*/std::nullopt,
+                                          /*Redirects=*/ {},
+                                          /*SecondsToWait=*/0,
+                                          /*MemoryLimit=*/0,
+                                          &message);
+  if (status != 0) {
+    std::cerr << "Linking " << output_file << " failed" << (message.empty() ? "" : ": " + message)
+              << "\n";
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+namespace bython::executor
+{
+aot_compiler::aot_compiler()
+    : aot_compiler(aot_options {})
+{
+}
+
+aot_compiler::aot_compiler(aot_options options_)
+    : options {options_}
+{
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmParser();
+  llvm::InitializeNativeTargetAsmPrinter();
+}
+
+auto aot_compiler::compile(std::filesystem::path const& input_file,
+                           std::filesystem::path const& output_file) -> int
+{
+  auto code = read_source(input_file);
+  if (!code) {
+    return -1;
+  }
+
+  auto target_builder = detect_target(this->options.target, this->options.opt_level);
+  if (!target_builder) {
+    return report_error(target_builder.takeError());
+  }
+  // Objects are linked into position-independent executables
+  target_builder->setRelocationModel(llvm::Reloc::PIC_);
+
+  auto target_machine = target_builder->createTargetMachine();
+  if (!target_machine) {
+    return report_error(target_machine.takeError());
+  }
+
+  auto context = llvm::LLVMContext {};
+  auto codegen = compile_program(
+      std::move(*code), input_file, context, **target_machine, this->options.codegen_threads);
+  if (!codegen || !add_entry_point(*codegen)) {
+    return -1;
+  }
+  backend::optimise(*codegen, this->options.opt_level, target_machine->get());
+
+  auto object_file = llvm::SmallString<128> {};
+  if (auto ec = llvm::sys::fs::createTemporaryFile("bython", "o", object_file)) {
+    std::cerr << "Unable to create a temporary object file: " << ec.message() << "\n";
+    return -1;
+  }
+
+  auto linked = false;
+  {
+    auto ec = std::error_code {};
+    auto out = llvm::raw_fd_ostream {object_file, ec, llvm::sys::fs::OF_None};
+    if (!ec && backend::emit(*codegen, backend::emit_kind::object, **target_machine, out)) {
+      out.close();
+      linked = link_executable(object_file.str().str(), output_file.string(), this->options);
+    } else {
+      std::cerr << "Unable to write object file " << object_file.str().str() << "\n";
+    }
+  }
+
+  llvm::sys::fs::remove(object_file);
+  return linked ? 0 : -1;
+}
+}  // namespace bython::executor
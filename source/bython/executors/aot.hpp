@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "bython/backend/optimise.hpp"
+#include "target.hpp"
+
+namespace bython::executor
+{
+struct aot_options
+{
+  backend::optimisation_level opt_level = backend::optimisation_level::O2;
+  target_options target;
+  // Threads generating code for the program's functions
+  unsigned codegen_threads = 1;
+  // Compiler driver used to link, and the bython_runtime archive linked in; empty picks the
+  // build's compiler and the archive installed next to the running driver
+  std::string linker;
+  std::filesystem::path runtime_library;
+};
+
+/// Compiles programs ahead of time into standalone executables linked against bython_runtime
+struct aot_compiler
+{
+  aot_compiler();
+  explicit aot_compiler(aot_options options);
+
+  auto compile(std::filesystem::path const& input_file, std::filesystem::path const& output_file)
+      -> int;
+
+private:
+  aot_options options;
+};
+}  // namespace bython::executor
@@ -1,111 +1,328 @@
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 #include "jit.hpp"
 
-#include <lexy/action/parse.hpp>
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/ExecutionEngine/GenericValue.h>
-#include <llvm/ExecutionEngine/MCJIT.h>
-#include <llvm/MC/TargetRegistry.h>
-#include <llvm/Support/ManagedStatic.h>
-#include <llvm/Support/TargetParser.h>
+#include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/ExecutorProcessControl.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/Layer.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FormatVariadic.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
-#include <llvm/Target/TargetOptions.h>
-#include <llvm/TargetParser/Host.h>
 #include <llvm/TargetParser/Triple.h>
 
-#include "bython/backend/builtin.hpp"
-#include "bython/backend/llvm.hpp"
-#include "bython/frontend/lexy.hpp"
-#include "bython/type_system/builtin.hpp"
+#include "bython/backend/emit.hpp"
+#include "bython/backend/optimise.hpp"
+#include "bython/runtime/runtime.hpp"
+#include "object_cache.hpp"
+#include "perf_map.hpp"
+#include "pipeline.hpp"
 
 namespace bython::executor
 {
 struct jit_compiler::jit_compiler_pimpl
 {
   /*
-   * LLVM details go here, e.g. llvm::ExecutionEngine, llvm::ExecutionSession
+   * LLVM details go here, e.g. llvm::orc::LLJIT, llvm::orc::ExecutionSession
    * This helps us keep LLVM linkage private between bython_lib and consumers thereof,
    * for example, the bython tests
    */
 
-  jit_compiler_pimpl()
+  explicit jit_compiler_pimpl(jit_options options_)
+      : options {options_}
   {
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmParser();
     llvm::InitializeNativeTargetAsmPrinter();
+    this->create_listeners();
   }
 
   ~jit_compiler_pimpl() = default;
 
   auto execute(std::filesystem::path const& input_file) -> int
   {
-    auto ifs = std::ifstream(input_file);
-    if (!ifs) {
-      std::cerr << "Unable to read from " << input_file << "; check that it exists!";
+    auto code = read_source(input_file);
+    if (!code) {
       return -1;
     }
 
-    auto code = std::string {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    auto target_builder = detect_target(this->options.target, this->options.opt_level);
+    if (!target_builder) {
+      return report_error(target_builder.takeError());
+    }
+
+    // Optimise with the same target the JIT will generate code for
+    auto target_machine = target_builder->createTargetMachine();
+    if (!target_machine) {
+      return report_error(target_machine.takeError());
+    }
+
+    // A cached object lets an unchanged program skip parsing, type checking and codegen entirely
+    auto cache = this->open_cache(code->text, *target_builder);
+    auto cached_object = cache ? cache->load() : nullptr;
 
-    auto parser = parser::lexy_code_frontend {};
-    auto parsed = parser.parse(code);
+    auto jit = this->create_jit(std::move(*target_builder), target_machine->get(), cache.get());
+    if (!jit) {
+      return report_error(jit.takeError());
+    }
+
+    auto context = llvm::orc::ThreadSafeContext {std::make_unique<llvm::LLVMContext>()};
+    if (auto error = define_builtins(**jit, *context.getContext())) {
+      return report_error(std::move(error));
+    }
 
-    if (parsed.has_error()) {
-      std::cerr << std::move(parsed).error() << "\n";
+    if (cached_object) {
+      if (auto error = (*jit)->addObjectFile(std::move(cached_object))) {
+        return report_error(std::move(error));
+      }
+    } else if (!this->add_program(**jit, *code, input_file, context, **target_machine)) {
       return -1;
     }
 
-    auto [metadata, module] = std::move(parsed).value();
-    auto context = llvm::LLVMContext {};
+    // Looking `main` up is what makes the JIT compile the program down to machine code
+    auto main_function = [&]
+    {
+      auto scope = llvm::TimeTraceScope {"JIT materialisation"};
+      return (*jit)->lookup("main");
+    }();
+    if (!main_function) {
+      llvm::consumeError(main_function.takeError());
+      std::cerr << "Cannot find main function! Exiting...\n";
+      return -1;
+    }
 
-    auto codegen = backend::compile(
-        std::string {input_file.filename()}, std::move(module), *metadata, context);
-    codegen->setSourceFileName(std::string {input_file});
-    // codegen->setTargetTriple("x86_64-pc-linux-gnu");
+    // `main` takes no arguments and returns nothing, so it can be called directly
+    auto scope = llvm::TimeTraceScope {"Execute"};
+    main_function->toPtr<void (*)()>()();
+    ::bython_flush();
+    return 0;
+  }
 
-    codegen->print(llvm::outs(), nullptr);
+private:
+  // Parses, type checks and compiles `code`, then hands the module to `jit`
+  auto add_program(llvm::orc::LLJIT& jit,
+                   parser::source code,
+                   std::filesystem::path const& input_file,
+                   llvm::orc::ThreadSafeContext context,
+                   llvm::TargetMachine& target_machine) const -> bool
+  {
+    auto codegen = compile_program(std::move(code),
+                                   input_file,
+                                   *context.getContext(),
+                                   target_machine,
+                                   this->options.codegen_threads);
+    if (!codegen) {
+      return false;
+    }
 
-    std::string error;
-    auto engine_builder = llvm::EngineBuilder(std::move(codegen));
-    engine_builder.setTargetOptions(llvm::TargetOptions {});
-    engine_builder.setErrorStr(&error);
-    engine_builder.setEngineKind(llvm::EngineKind::JIT);
-    engine_builder.setVerifyModules(true);
-    engine_builder.setOptLevel(llvm::CodeGenOpt::None);
+    if (!this->options.lazy) {
+      backend::optimise(*codegen, this->options.opt_level, &target_machine);
+    }
 
-    auto engine = std::unique_ptr<llvm::ExecutionEngine>(engine_builder.create());
+    if (!emit_artifact(*codegen, this->options.emit, target_machine, input_file)) {
+      return false;
+    }
 
-    if (!engine || !error.empty()) {
-      std::cerr << "JIT Error: " << error << "\n";
-      return -1;
+    auto module_ir = llvm::orc::ThreadSafeModule {std::move(codegen), context};
+    auto added = this->options.lazy
+        ? static_cast<llvm::orc::LLLazyJIT&>(jit).addLazyIRModule(std::move(module_ir))
+        : jit.addIRModule(std::move(module_ir));
+    if (added) {
+      report_error(std::move(added));
+      return false;
+    }
+    return true;
+  }
+
+  auto open_cache(std::string_view code,
+                  llvm::orc::JITTargetMachineBuilder const& target_builder) const
+      -> std::unique_ptr<object_cache>
+  {
+    // Lazy partitions are compiled one by one, and emitting needs the module, so neither can
+    // be served from a single cached object
+    if (this->options.cache_directory.empty() || this->options.lazy
+        || this->options.emit != backend::emit_kind::none)
+    {
+      return nullptr;
+    }
+
+    auto configuration = llvm::formatv("O{0};{1};{2};{3}",
+                                       static_cast<int>(this->options.opt_level),
+                                       target_builder.getTargetTriple().str(),
+                                       target_builder.getCPU(),
+                                       target_builder.getFeatures().getString())
+                             .str();
+    return std::make_unique<object_cache>(this->options.cache_directory, code, configuration);
+  }
+
+  auto create_jit(llvm::orc::JITTargetMachineBuilder target_builder,
+                  llvm::TargetMachine* target_machine,
+                  object_cache* cache) const -> llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>>
+  {
+    if (!this->options.lazy) {
+      auto builder = llvm::orc::LLJITBuilder {};
+      builder.setJITTargetMachineBuilder(std::move(target_builder));
+      if (!this->listeners.empty()) {
+        builder.setObjectLinkingLayerCreator(this->listening_linking_layer());
+      }
+      if (cache != nullptr) {
+        builder.setCompileFunctionCreator(
+            [cache](llvm::orc::JITTargetMachineBuilder compile_target)
+                -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>>
+            {
+              return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(compile_target),
+                                                                        cache);
+            });
+      }
+      return builder.create();
+    }
+
+    auto lazy_builder = llvm::orc::LLLazyJITBuilder {};
+    lazy_builder.setJITTargetMachineBuilder(std::move(target_builder));
+    if (!this->listeners.empty()) {
+      lazy_builder.setObjectLinkingLayerCreator(this->listening_linking_layer());
     }
 
-    for (auto&& builtin : {type_system::function_tag::put_i64,
-                           type_system::function_tag::put_u64,
-                           type_system::function_tag::put_f32,
-                           type_system::function_tag::put_f64})
+    auto jit = lazy_builder.create();
+    if (!jit) {
+      return jit.takeError();
+    }
+
+    // The compile-on-demand layer hands down one partition per requested function; optimising
+    // here rather than up front keeps uncalled functions from ever reaching the pass pipeline
+    (*jit)->getIRTransformLayer().setTransform(
+        [level = this->options.opt_level, target_machine](
+            llvm::orc::ThreadSafeModule partition,
+            llvm::orc::MaterializationResponsibility const& /*responsibility*/)
+            -> llvm::Expected<llvm::orc::ThreadSafeModule>
+        {
+          partition.withModuleDo(
+              [&](llvm::Module& module_)
+              {
+                // Names the functions being materialised, so a trace shows which ones ever were
+                auto scope = llvm::TimeTraceScope {
+                    "Materialise partition", [&] { return defined_functions(module_); }};
+                backend::optimise(module_, level, target_machine);
+              });
+          return std::move(partition);
+        });
+
+    return std::unique_ptr<llvm::orc::LLJIT> {std::move(*jit)};
+  }
+
+  static auto defined_functions(llvm::Module const& module_) -> std::string
+  {
+    auto names = std::string {};
+    for (auto const& function : module_) {
+      if (!function.isDeclaration()) {
+        names += names.empty() ? "" : ",";
+        names += function.getName();
+      }
+    }
+    return names;
+  }
+
+  auto create_listeners() -> void
+  {
+    for (auto listener : this->options.listeners) {
+      switch (listener) {
+        case jit_listener::perf_map:
+          if (this->perf_map == nullptr) {
+            this->perf_map = std::make_unique<perf_map_listener>();
+            this->listeners.push_back(this->perf_map.get());
+          }
+          break;
+        case jit_listener::jitdump:
+          if (auto* jitdump = llvm::JITEventListener::createPerfJITEventListener()) {
+            this->listeners.push_back(jitdump);
+          } else {
+            std::cerr << "LLVM was built without perf support; no jitdump will be written\n";
+          }
+          break;
+        case jit_listener::gdb:
+          this->listeners.push_back(llvm::JITEventListener::createGDBRegistrationListener());
+          break;
+      }
+    }
+  }
+
+  // Only RuntimeDyld notifies JITEventListeners, so listening selects it over JITLink
+  auto listening_linking_layer() const -> llvm::orc::LLJITBuilderState::ObjectLinkingLayerCreator
+  {
+    return [listeners = this->listeners](llvm::orc::ExecutionSession& session,
+                                         llvm::Triple const& /*triple*/)
+               -> llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>>
     {
-      auto bmetadata = backend::builtin_function(context, builtin);
-      engine->addGlobalMapping(bmetadata.name, bmetadata.procedure_addr);
+      auto layer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+          session, [] { return std::make_unique<llvm::SectionMemoryManager>(); });
+      for (auto* listener : listeners) {
+        layer->registerJITEventListener(*listener);
+      }
+      return layer;
+    };
+  }
+
+  static auto emit_artifact(llvm::Module const& module_,
+                            backend::emit_kind kind,
+                            llvm::TargetMachine& target_machine,
+                            std::filesystem::path const& input_file) -> bool
+  {
+    if (kind == backend::emit_kind::none) {
+      return true;
     }
 
-    engine->finalizeObject();
-    if (auto main_function = engine->FindFunctionNamed("main"); main_function != nullptr) {
-      engine->runFunction(main_function, {});
-      return 0;
+    auto emitted = false;
+    if (kind == backend::emit_kind::object) {
+      auto object_file = input_file.stem();
+      object_file += ".o";
+      auto ec = std::error_code {};
+      auto out = llvm::raw_fd_ostream {object_file.string(), ec, llvm::sys::fs::OF_None};
+      if (ec) {
+        std::cerr << "Unable to open " << object_file << ": " << ec.message() << "\n";
+        return false;
+      }
+      emitted = backend::emit(module_, kind, target_machine, out);
+    } else {
+      emitted = backend::emit(module_, kind, target_machine, llvm::outs());
     }
 
-    std::cerr << "Cannot find main function! Exiting...\n";
-    return -1;
+    if (!emitted) {
+      std::cerr << "Target cannot emit the requested kind of file\n";
+    }
+    return emitted;
   }
+
+  jit_options options;
+  // Outlive every JIT created by `execute`, which only borrows them
+  std::unique_ptr<perf_map_listener> perf_map;
+  std::vector<llvm::JITEventListener*> listeners;
 };
 
 jit_compiler::jit_compiler()
-    : impl {std::make_unique<jit_compiler::jit_compiler_pimpl>()}
+    : jit_compiler(jit_options {})
+{
+}
+
+jit_compiler::jit_compiler(jit_options options)
+    : impl {std::make_unique<jit_compiler::jit_compiler_pimpl>(options)}
 {
 }
 jit_compiler::~jit_compiler() = default;
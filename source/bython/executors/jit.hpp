@@ -3,12 +3,46 @@
 #include <filesystem>
 #include <memory>
 #include <string_view>
+#include <vector>
+
+#include "bython/backend/emit.hpp"
+#include "bython/backend/optimise.hpp"
+#include "target.hpp"
 
 namespace bython::executor
 {
+/// Profilers and debuggers that can be told where JIT'd functions live
+enum class jit_listener
+{
+  // `/tmp/perf-<pid>.map`, read directly by `perf report`
+  perf_map,
+  // `jit-<pid>.dump` for `perf inject --jit`; needs an LLVM built with LLVM_USE_PERF
+  jitdump,
+  // GDB's JIT interface, so backtraces and breakpoints see JIT'd functions
+  gdb,
+};
+
+struct jit_options
+{
+  backend::optimisation_level opt_level = backend::optimisation_level::O0;
+  // Defer optimisation and codegen of each function until its first call
+  bool lazy = false;
+  // Diagnostic output of the module handed to the JIT; IR and assembly go to stdout,
+  // objects to `<input stem>.o` in the working directory
+  backend::emit_kind emit = backend::emit_kind::none;
+  // Reuse objects compiled by earlier runs of the same program; empty disables the cache
+  std::filesystem::path cache_directory;
+  target_options target;
+  // Threads generating code for the program's functions
+  unsigned codegen_threads = 1;
+  // Off by default, since registering objects costs time on every load
+  std::vector<jit_listener> listeners;
+};
+
 struct jit_compiler
 {
   jit_compiler();
+  explicit jit_compiler(jit_options options);
   ~jit_compiler();
 
   jit_compiler(jit_compiler const&) = delete;
@@ -0,0 +1,101 @@
+#include <string>
+#include <system_error>
+
+#include "object_cache.hpp"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
+
+#ifndef BYTHON_VERSION
+#  define BYTHON_VERSION "unknown"
+#endif
+
+namespace
+{
+/// Identifies the build of the running compiler by its executable's path, size and modification
+/// time. BYTHON_VERSION stays the same across rebuilds, so it alone would serve objects compiled
+/// by older builds after the compiler changes.
+auto compiler_identity() -> std::string const&
+{
+  static auto const identity = []
+  {
+    auto anchor = reinterpret_cast<void*>(&compiler_identity);
+    auto executable = llvm::sys::fs::getMainExecutable(nullptr, anchor);
+
+    auto identity = std::string {BYTHON_VERSION};
+    identity.append(1, '\0').append(executable);
+
+    auto status = llvm::sys::fs::file_status {};
+    if (!executable.empty() && !llvm::sys::fs::status(executable, status)) {
+      identity.append(1, '\0').append(std::to_string(status.getSize()));
+      identity.append(1, '\0').append(
+          std::to_string(status.getLastModificationTime().time_since_epoch().count()));
+    }
+    return identity;
+  }();
+  return identity;
+}
+
+auto entry_name(std::string_view source, std::string_view configuration) -> std::string
+{
+  auto key = compiler_identity();
+  key.append(1, '\0').append(LLVM_VERSION_STRING);
+  key.append(1, '\0').append(configuration);
+  key.append(1, '\0').append(source);
+
+  auto hash = llvm::xxh3_64bits(llvm::arrayRefFromStringRef(key));
+  return llvm::utohexstr(hash, /*LowerCase=*/true) + ".o";
+}
+}  // namespace
+
+namespace bython::executor
+{
+object_cache::object_cache(std::filesystem::path const& directory,
+                           std::string_view source,
+                           std::string_view configuration)
+    : m_entry {directory / entry_name(source, configuration)}
+{
+  // Failing to create the directory only means that entries cannot be stored
+  auto ec = std::error_code {};
+  std::filesystem::create_directories(directory, ec);
+}
+
+auto object_cache::load() const -> std::unique_ptr<llvm::MemoryBuffer>
+{
+  auto object = llvm::MemoryBuffer::getFile(
+      this->m_entry.string(), /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!object) {
+    return nullptr;
+  }
+  return std::move(*object);
+}
+
+auto object_cache::notifyObjectCompiled(llvm::Module const* /*module_*/,
+                                        llvm::MemoryBufferRef object) -> void
+{
+  // Write through a temporary so that concurrent runs never observe a partial entry
+  auto temporary = llvm::sys::fs::TempFile::create(this->m_entry.string() + ".%%%%%%.tmp");
+  if (!temporary) {
+    llvm::consumeError(temporary.takeError());
+    return;
+  }
+
+  {
+    auto out = llvm::raw_fd_ostream {temporary->FD, /*shouldClose=*/false};
+    out << object.getBuffer();
+  }
+
+  if (auto error = temporary->keep(this->m_entry.string())) {
+    llvm::consumeError(std::move(error));
+  }
+}
+
+auto object_cache::getObject(llvm::Module const* /*module_*/) -> std::unique_ptr<llvm::MemoryBuffer>
+{
+  return this->load();
+}
+}  // namespace bython::executor
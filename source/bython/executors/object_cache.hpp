@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace bython::executor
+{
+/// On-disk cache holding the compiled object for one program. The entry is keyed by everything
+/// that determines the machine code: the source text, the build of the compiler, the LLVM version,
+/// and a configuration string describing the optimisation level and target.
+class object_cache final : public llvm::ObjectCache
+{
+public:
+  object_cache(std::filesystem::path const& directory,
+               std::string_view source,
+               std::string_view configuration);
+
+  /// Previously compiled object for this program, or nullptr on a miss
+  auto load() const -> std::unique_ptr<llvm::MemoryBuffer>;
+
+  auto notifyObjectCompiled(llvm::Module const* module_, llvm::MemoryBufferRef object)
+      -> void override;
+  auto getObject(llvm::Module const* module_) -> std::unique_ptr<llvm::MemoryBuffer> override;
+
+private:
+  std::filesystem::path m_entry;
+};
+}  // namespace bython::executor
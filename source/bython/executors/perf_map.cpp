@@ -0,0 +1,77 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "perf_map.hpp"
+
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/Process.h>
+
+namespace
+{
+auto open_map(std::filesystem::path const& path) -> std::unique_ptr<llvm::raw_fd_ostream>
+{
+  auto ec = std::error_code {};
+  auto map = std::make_unique<llvm::raw_fd_ostream>(path.string(), ec, llvm::sys::fs::OF_Append);
+  if (ec) {
+    llvm::errs() << "Unable to open " << path.string() << ": " << ec.message() << "\n";
+    return nullptr;
+  }
+  return map;
+}
+}  // namespace
+
+namespace bython::executor
+{
+perf_map_listener::perf_map_listener()
+    : perf_map_listener("/tmp/perf-" + std::to_string(llvm::sys::Process::getProcessId()) + ".map")
+{
+}
+
+perf_map_listener::perf_map_listener(std::filesystem::path const& path)
+    : m_map {open_map(path)}
+{
+}
+
+auto perf_map_listener::notifyObjectLoaded(ObjectKey /*key*/,
+                                           llvm::object::ObjectFile const& object,
+                                           llvm::RuntimeDyld::LoadedObjectInfo const& info) -> void
+{
+  if (this->m_map == nullptr) {
+    return;
+  }
+
+  // The debug object carries the addresses the sections were loaded at
+  auto debug_object = info.getObjectForDebug(object);
+  if (debug_object.getBinary() == nullptr) {
+    return;
+  }
+
+  auto lock = std::lock_guard {this->m_mutex};
+  for (auto&& [symbol, size] : llvm::object::computeSymbolSizes(*debug_object.getBinary())) {
+    auto type = symbol.getType();
+    if (!type || *type != llvm::object::SymbolRef::ST_Function) {
+      llvm::consumeError(type.takeError());
+      continue;
+    }
+
+    auto name = symbol.getName();
+    auto address = symbol.getAddress();
+    if (!name || !address) {
+      llvm::consumeError(name.takeError());
+      llvm::consumeError(address.takeError());
+      continue;
+    }
+
+    *this->m_map << llvm::format_hex_no_prefix(*address, 1) << ' '
+                << llvm::format_hex_no_prefix(size, 1) << ' ' << *name << '\n';
+  }
+
+  // perf may read the map while the program is still running, or after it crashed
+  this->m_map->flush();
+}
+}  // namespace bython::executor
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace bython::executor
+{
+/// Appends the address, size and name of every JIT'd function to `/tmp/perf-<pid>.map`, the file
+/// `perf report` reads to symbolise samples that land in anonymous executable memory
+class perf_map_listener final : public llvm::JITEventListener
+{
+public:
+  perf_map_listener();
+  // Appends to `path` instead, so the entries can be inspected without perf
+  explicit perf_map_listener(std::filesystem::path const& path);
+
+  auto notifyObjectLoaded(ObjectKey key,
+                          llvm::object::ObjectFile const& object,
+                          llvm::RuntimeDyld::LoadedObjectInfo const& info) -> void override;
+
+private:
+  std::mutex m_mutex;
+  // Null when the map could not be opened
+  std::unique_ptr<llvm::raw_fd_ostream> m_map;
+};
+}  // namespace bython::executor
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "pipeline.hpp"
+
+#include "bython/ast/folding.hpp"
+#include "bython/backend/builtin.hpp"
+#include "bython/backend/llvm.hpp"
+#include "bython/frontend/lexy.hpp"
+#include "bython/type_system/builtin.hpp"
+
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/Shared/ExecutorSymbolDef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/TargetParser/SubtargetFeature.h>
+
+namespace bython::executor
+{
+auto read_source(std::filesystem::path const& input_file) -> std::optional<parser::source>
+{
+  // Without a required null terminator, any file beyond a few pages is mapped read-only
+  auto buffer = llvm::MemoryBuffer::getFile(
+      input_file.string(), /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!buffer) {
+    std::cerr << "Unable to read from " << input_file << "; check that it exists!";
+    return std::nullopt;
+  }
+
+  auto owner = std::shared_ptr<llvm::MemoryBuffer const> {std::move(*buffer)};
+  auto text = owner->getBuffer();
+  return parser::source {{text.data(), text.size()}, std::move(owner)};
+}
+
+auto detect_target(target_options const& target, backend::optimisation_level level)
+    -> llvm::Expected<llvm::orc::JITTargetMachineBuilder>
+{
+  // Picks up llvm::sys::getHostCPUName and getHostCPUFeatures
+  auto target_builder = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!target_builder) {
+    return target_builder.takeError();
+  }
+  target_builder->setCodeGenOptLevel(codegen_opt_level(level));
+
+  // An explicit CPU brings its own default features instead of the host's
+  if (!target.cpu.empty() && target.cpu != "native") {
+    target_builder->setCPU(target.cpu);
+    target_builder->getFeatures() = llvm::SubtargetFeatures {};
+  }
+
+  for (auto const& feature : target.features) {
+    target_builder->getFeatures().AddFeature(feature);
+  }
+
+  return target_builder;
+}
+
+auto compile_program(parser::source code,
+                     std::filesystem::path const& input_file,
+                     llvm::LLVMContext& context,
+                     llvm::TargetMachine const& target_machine,
+                     unsigned codegen_threads) -> std::unique_ptr<llvm::Module>
+{
+  auto parsed = [&]
+  {
+    auto scope = llvm::TimeTraceScope {"Frontend", input_file.string()};
+    return parser::lexy_code_frontend {}.parse(std::move(code));
+  }();
+
+  if (parsed.has_error()) {
+    std::cerr << std::move(parsed).error() << "\n";
+    return nullptr;
+  }
+
+  auto [metadata, module] = std::move(parsed).value();
+  {
+    auto scope = llvm::TimeTraceScope {"Constant folding"};
+    ast::fold_constants(*module);
+  }
+
+  auto codegen = std::unique_ptr<llvm::Module> {};
+  try {
+    codegen = backend::compile(
+        std::string {input_file.filename()}, *module, *metadata, context, codegen_threads);
+  } catch (std::logic_error const&) {
+    // Codegen has already reported why it gave up
+    return nullptr;
+  }
+  codegen->setSourceFileName(std::string {input_file});
+  codegen->setDataLayout(target_machine.createDataLayout());
+  codegen->setTargetTriple(target_machine.getTargetTriple().str());
+  return codegen;
+}
+
+auto define_builtins(llvm::orc::LLJIT& jit, llvm::LLVMContext& context) -> llvm::Error
+{
+  auto symbols = llvm::orc::SymbolMap {};
+  for (auto&& builtin : {type_system::function_tag::put_i64,
+                         type_system::function_tag::put_u64,
+                         type_system::function_tag::put_f32,
+                         type_system::function_tag::put_f64})
+  {
+    auto bmetadata = backend::builtin_function(context, builtin);
+    symbols[jit.mangleAndIntern(bmetadata.name)] = llvm::orc::ExecutorSymbolDef {
+        llvm::orc::ExecutorAddr {bmetadata.procedure_addr},
+        llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable};
+  }
+
+  return jit.getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(symbols)));
+}
+
+auto codegen_opt_level(backend::optimisation_level level) -> llvm::CodeGenOpt::Level
+{
+  switch (level) {
+    case backend::optimisation_level::O0:
+      return llvm::CodeGenOpt::None;
+    case backend::optimisation_level::O1:
+      return llvm::CodeGenOpt::Less;
+    case backend::optimisation_level::O2:
+    case backend::optimisation_level::Os:
+      return llvm::CodeGenOpt::Default;
+    case backend::optimisation_level::O3:
+      return llvm::CodeGenOpt::Aggressive;
+  }
+  return llvm::CodeGenOpt::None;
+}
+
+auto report_error(llvm::Error error) -> int
+{
+  std::cerr << "Error: " << llvm::toString(std::move(error)) << "\n";
+  return -1;
+}
+}  // namespace bython::executor
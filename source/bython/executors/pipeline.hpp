@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "bython/backend/optimise.hpp"
+#include "bython/frontend/frontend.hpp"
+#include "target.hpp"
+
+namespace bython::executor
+{
+/// Contents of `input_file`, mapped into memory rather than copied where the file is large enough
+/// for that to pay off, or nullopt (after reporting on stderr) when it cannot be read
+auto read_source(std::filesystem::path const& input_file) -> std::optional<parser::source>;
+
+/// Target for the host process: its triple, plus the host CPU name and features unless
+/// overridden by `target`
+auto detect_target(target_options const& target, backend::optimisation_level level)
+    -> llvm::Expected<llvm::orc::JITTargetMachineBuilder>;
+
+/// Parses, constant folds, type checks and lowers `code` into an unoptimised module laid out for
+/// `target_machine`, generating code on up to `codegen_threads` threads. Errors are reported on
+/// stderr and yield nullptr.
+auto compile_program(parser::source code,
+                     std::filesystem::path const& input_file,
+                     llvm::LLVMContext& context,
+                     llvm::TargetMachine const& target_machine,
+                     unsigned codegen_threads) -> std::unique_ptr<llvm::Module>;
+
+/// Exposes the runtime's put_* implementations to code JIT'd by `jit` as absolute symbols
+auto define_builtins(llvm::orc::LLJIT& jit, llvm::LLVMContext& context) -> llvm::Error;
+
+auto codegen_opt_level(backend::optimisation_level level) -> llvm::CodeGenOpt::Level;
+
+/// Prints `error` on stderr and returns the driver's failure exit code
+auto report_error(llvm::Error error) -> int;
+}  // namespace bython::executor
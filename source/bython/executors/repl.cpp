@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "repl.hpp"
+
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "bython/ast/folding.hpp"
+#include "bython/backend/llvm.hpp"
+#include "bython/frontend/lexy.hpp"
+#include "bython/runtime/runtime.hpp"
+#include "pipeline.hpp"
+
+namespace bython::executor
+{
+namespace
+{
+auto trim(std::string_view text) -> std::string_view
+{
+  auto const first = text.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+auto starts_with_keyword(std::string_view text, std::string_view keyword) -> bool
+{
+  return text.starts_with(keyword)
+      && (text.size() == keyword.size() || text[keyword.size()] == ' '
+          || text[keyword.size()] == '(');
+}
+
+/// Whether `buffer` holds a whole input: its braces balance, and a definition has reached its body
+auto is_complete(std::string_view buffer) -> bool
+{
+  auto const opened = std::ranges::count(buffer, '{');
+  if (opened != std::ranges::count(buffer, '}')) {
+    return false;
+  }
+
+  auto const text = trim(buffer);
+  return opened > 0
+      || !(starts_with_keyword(text, "def") || starts_with_keyword(text, "struct"));
+}
+
+/// Parses `text` with the entry point of the grammar that matches how it starts
+auto parse_input(std::string_view text) -> parser::frontend_parse_result
+{
+  auto frontend = parser::lexy_code_frontend {};
+  if (starts_with_keyword(text, "def") || starts_with_keyword(text, "struct")) {
+    return frontend.parse(text);
+  }
+  if (starts_with_keyword(text, "val") || starts_with_keyword(text, "discard")
+      || starts_with_keyword(text, "if") || starts_with_keyword(text, "return"))
+  {
+    return frontend.parse_statement(text);
+  }
+
+  // Expressions are evaluated for their value, so a terminating semicolon is optional
+  if (text.ends_with(';')) {
+    text.remove_suffix(1);
+  }
+  return frontend.parse_expression(text);
+}
+}  // namespace
+
+struct repl::repl_pimpl
+{
+  explicit repl_pimpl(repl_options options_)
+      : options {options_}
+  {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmParser();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  auto run(std::istream& in, bool interactive) -> int
+  {
+    auto target_builder = detect_target(this->options.target, this->options.opt_level);
+    if (!target_builder) {
+      return report_error(target_builder.takeError());
+    }
+
+    auto target_machine = target_builder->createTargetMachine();
+    if (!target_machine) {
+      return report_error(target_machine.takeError());
+    }
+
+    auto jit = llvm::orc::LLJITBuilder {}
+                   .setJITTargetMachineBuilder(std::move(*target_builder))
+                   .create();
+    if (!jit) {
+      return report_error(jit.takeError());
+    }
+
+    if (auto error = define_builtins(**jit, *this->context.getContext())) {
+      return report_error(std::move(error));
+    }
+
+    auto buffer = std::string {};
+    auto line = std::string {};
+    for (prompt(interactive, true); std::getline(in, line); prompt(interactive, buffer.empty())) {
+      // Blank and comment lines between inputs are skipped rather than parsed
+      if (buffer.empty() && (trim(line).empty() || trim(line).starts_with('#'))) {
+        continue;
+      }
+
+      buffer += line;
+      buffer += '\n';
+      if (!is_complete(buffer)) {
+        continue;
+      }
+
+      this->evaluate(**jit, **target_machine, trim(buffer));
+      buffer.clear();
+    }
+
+    if (!trim(buffer).empty()) {
+      std::cerr << "Unexpected end of input\n";
+      return -1;
+    }
+    return 0;
+  }
+
+  repl_options options;
+  backend::session session;
+  llvm::orc::ThreadSafeContext context {std::make_unique<llvm::LLVMContext>()};
+  // Later inputs may refer to earlier ones, so their trees are kept for the whole session
+  std::vector<ast::tree> inputs;
+
+private:
+  static auto prompt(bool interactive, bool fresh) -> void
+  {
+    if (interactive) {
+      std::cout << (fresh ? ">>> " : "... ") << std::flush;
+    }
+  }
+
+  auto evaluate(llvm::orc::LLJIT& jit, llvm::TargetMachine& target_machine, std::string_view text)
+      -> void
+  {
+    auto parsed = parse_input(text);
+    if (parsed.has_error()) {
+      std::cerr << std::move(parsed).error() << "\n";
+      return;
+    }
+
+    auto [metadata, tree] = std::move(parsed).value();
+    ast::fold_constants(*tree);
+
+    auto compiled = this->session.compile(*tree, *metadata, *this->context.getContext());
+    this->inputs.push_back(std::move(tree));
+    if (!compiled) {
+      return;
+    }
+
+    compiled->module_->setDataLayout(target_machine.createDataLayout());
+    compiled->module_->setTargetTriple(target_machine.getTargetTriple().str());
+    backend::optimise(*compiled->module_, this->options.opt_level, &target_machine);
+
+    // Every function the input defines is looked up right away, so that link errors surface now
+    // rather than on a call from a later input
+    auto defined = std::vector<std::string> {};
+    for (auto const& function : *compiled->module_) {
+      if (!function.isDeclaration()) {
+        defined.emplace_back(function.getName());
+      }
+    }
+
+    // A failed input is removed from the JIT again, so that its names can be defined afresh
+    auto tracker = jit.getMainJITDylib().createResourceTracker();
+    auto module_ir = llvm::orc::ThreadSafeModule {std::move(compiled->module_), this->context};
+    if (auto error = jit.addIRModule(tracker, std::move(module_ir))) {
+      this->discard(*tracker, std::move(error));
+      return;
+    }
+
+    for (auto const& name : defined) {
+      if (auto address = jit.lookup(name); !address) {
+        this->discard(*tracker, address.takeError());
+        return;
+      }
+    }
+
+    if (!compiled->entry.empty()) {
+      auto entry = jit.lookup(compiled->entry);
+      if (!entry) {
+        this->discard(*tracker, entry.takeError());
+        return;
+      }
+
+      // Entries take no arguments and return nothing, like `main`
+      entry->toPtr<void (*)()>()();
+      ::bython_flush();
+    }
+
+    this->session.commit();
+  }
+
+  auto discard(llvm::orc::ResourceTracker& tracker, llvm::Error error) -> void
+  {
+    report_error(std::move(error));
+    this->session.rollback();
+    if (auto removed = tracker.remove()) {
+      report_error(std::move(removed));
+    }
+  }
+};
+
+repl::repl()
+    : repl(repl_options {})
+{
+}
+
+repl::repl(repl_options options)
+    : impl {std::make_unique<repl::repl_pimpl>(options)}
+{
+}
+
+repl::~repl() = default;
+
+repl::repl(repl&&) = default;
+auto repl::operator=(repl&&) noexcept -> repl& = default;
+
+auto repl::run(std::istream& in, bool interactive) -> int
+{
+  return this->impl->run(in, interactive);
+}
+}  // namespace bython::executor
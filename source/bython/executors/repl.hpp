@@ -0,0 +1,40 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+
+#include "bython/backend/optimise.hpp"
+#include "target.hpp"
+
+namespace bython::executor
+{
+struct repl_options
+{
+  backend::optimisation_level opt_level = backend::optimisation_level::O0;
+  target_options target;
+};
+
+/// Reads definitions, statements and expressions one at a time and runs each as soon as it is
+/// complete. Every input is compiled into a module of its own and added to one long-lived JIT,
+/// so earlier inputs are never compiled again.
+struct repl
+{
+  repl();
+  explicit repl(repl_options options);
+  ~repl();
+
+  repl(repl const&) = delete;
+  auto operator=(repl const&) noexcept -> repl& = delete;
+
+  repl(repl&&);
+  auto operator=(repl&&) noexcept -> repl&;
+
+  /// Runs inputs from `in` until it is exhausted, prompting on stdout when `interactive`.
+  /// Inputs that fail to compile are reported and skipped.
+  auto run(std::istream& in, bool interactive) -> int;
+
+private:
+  struct repl_pimpl;
+  std::unique_ptr<repl_pimpl> impl;
+};
+}  // namespace bython::executor
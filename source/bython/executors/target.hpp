@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bython::executor
+{
+/// Overrides for the machine code target, which otherwise is the host CPU with all of its features
+struct target_options
+{
+  // CPU to generate code for; empty or "native" selects the host CPU and its features
+  std::string cpu;
+  // Features to enable ("+avx2") or disable ("-avx512f") on top of the CPU's
+  std::vector<std::string> features;
+};
+}  // namespace bython::executor
@@ -5,6 +5,7 @@
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <string_view>
 #include <variant>
 
 #include "bython/ast.hpp"
@@ -34,17 +35,25 @@ struct parse_metadata
                             frontend_error_report report) const -> std::ostream& = 0;
 };
 
+/// Source text along with whatever keeps it alive, such as a file mapping. The metadata of a tree
+/// parsed from it shares `owner`, so diagnostics can quote the text after the caller lets go.
+struct source
+{
+  std::string_view text;
+  std::shared_ptr<void const> owner;
+};
+
 struct frontend_parse_result
 {
   frontend_parse_result() = delete;
 
-  frontend_parse_result(std::unique_ptr<parse_metadata> tree, std::unique_ptr<ast::node> ast);
+  frontend_parse_result(std::unique_ptr<parse_metadata> tree, ast::tree ast);
   explicit frontend_parse_result(std::string error);
 
   auto has_value() const -> bool;
   auto has_error() const -> bool;
 
-  using value_type = std::tuple<std::unique_ptr<parse_metadata>, std::unique_ptr<ast::node>>;
+  using value_type = std::tuple<std::unique_ptr<parse_metadata>, ast::tree>;
 
   auto value() && -> value_type;
   auto error() && -> std::string;
@@ -62,6 +71,7 @@ struct frontend
   frontend(frontend const&) = delete;
 
   virtual auto parse(std::string_view) -> frontend_parse_result = 0;
+  virtual auto parse(source) -> frontend_parse_result = 0;
   virtual auto parse_expression(std::string_view) -> frontend_parse_result = 0;
   virtual auto parse_statement(std::string_view) -> frontend_parse_result = 0;
 };
@@ -1,14 +1,15 @@
 #include <concepts>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <ostream>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include "lexy.hpp"
 
-#include <boost/container_hash/hash.hpp>  // uuid hasher
-#include <boost/uuid/uuid.hpp>  // uuid class
 #include <lexy/action/parse.hpp>
 #include <lexy/callback.hpp>
 #include <lexy/callback/adapter.hpp>
@@ -25,6 +26,7 @@
 #include "bython/ast.hpp"
 #include "bython/ast/expression.hpp"
 #include "bython/ast/statement.hpp"
+#include "bython/ast/symbol.hpp"
 
 namespace dsl = lexy::dsl;
 
@@ -65,13 +67,13 @@ struct lexy_grammar
           auto begin = lexy::get_input_location(state.input, startptr);
           auto end = lexy::get_input_location(state.input, endptr);
 
-          using LexySpan = typename decltype(state.span_lookup)::mapped_type;
+          using LexySpan = typename decltype(state.span_lookup)::value_type::value_type;
           auto node_span = LexySpan {.begin = begin, .end = end};
 
           if constexpr (is_unique_ptr<std::remove_cvref_t<Value>>::value) {
-            state.span_lookup.insert({node->uuid, std::move(node_span)});
+            state.record_span(node->id, std::move(node_span));
           } else {
-            state.span_lookup.insert({node.uuid, std::move(node_span)});
+            state.record_span(node.id, std::move(node_span));
           }
           return node;
         });
@@ -98,20 +100,38 @@ struct lexy_grammar
         identifier.reserve(funcdef_, return_, variable_, struct_, if_, elif_, else_, as_, discard_);
   };
 
+  // Interns the identifier straight from the input buffer, without an intermediate std::string
+  static constexpr auto interned = lexy::callback<ast::symbol>(
+      [](auto lexeme) { return ast::intern(std::string_view {lexeme.begin(), lexeme.end()}); });
+
   struct symbol_identifier
   {
     static constexpr auto rule = keyword::reserved;
-    static constexpr auto value = lexy::as_string<std::string>;
+    static constexpr auto value = interned;
   };
 
   struct type_identifier
   {
     static constexpr auto rule = keyword::reserved;
-    static constexpr auto value = lexy::as_string<std::string>;
+    static constexpr auto value = interned;
   };
 
+  // Drop-in for lexy::new_ which places nodes into the arena of the enclosing parse
   template<typename T, typename U>
-  static constexpr auto new_unique_ptr = lexy::new_<T, std::unique_ptr<U>>;
+  struct arena_new
+  {
+    using return_type = ast::node_ptr<U>;
+
+    template<typename... Args>
+      requires std::constructible_from<T, Args&&...>
+    constexpr auto operator()(Args&&... args) const -> return_type
+    {
+      return ast::make_node<T>(std::forward<Args>(args)...);
+    }
+  };
+
+  template<typename T, typename U>
+  static constexpr auto new_unique_ptr = arena_new<T, U> {};
 
   /* === Expressions === */
   template<typename T>
@@ -450,7 +470,7 @@ struct lexy_grammar
                         | dsl::error<missing_statement>);
     }();
 
-    static constexpr auto value = lexy::forward<std::unique_ptr<ast::statement>>;
+    static constexpr auto value = lexy::forward<ast::statement_ptr>;
   };
 
   struct inner_compound_body
@@ -497,12 +517,12 @@ struct lexy_grammar
     }();
 
     static constexpr auto value = lexy::callback<ast::function_def>(
-        [](std::string name,
+        [](ast::symbol name,
            ast::parameter_list params,
-           std::optional<std::string> rettype,
+           std::optional<ast::symbol> rettype,
            ast::statements body)
         {
-          auto signature = ast::signature(std::move(name), std::move(params), std::move(rettype));
+          auto signature = ast::signature(name, std::move(params), rettype);
           return ast::function_def(std::move(signature), std::move(body));
         });
   };
@@ -563,14 +583,15 @@ struct lexy_frontend
     lexy::input_location<Input> end;
   };
 
-  using span_map =
-      std::unordered_map<boost::uuids::uuid, lexy_span, boost::hash<boost::uuids::uuid>>;
+  // Indexed by ast::node_id; nodes without a recorded span hold std::nullopt
+  using span_map = std::vector<std::optional<lexy_span>>;
 
   struct lexy_parse_result final : p::parse_metadata
   {
-    lexy_parse_result(Input input, span_map span_lookup)
+    lexy_parse_result(Input input, span_map span_lookup, std::shared_ptr<void const> owner)
         : m_input {std::move(input)}
         , m_span_lookup {std::move(span_lookup)}
+        , m_owner {std::move(owner)}
     {
     }
 
@@ -578,12 +599,11 @@ struct lexy_frontend
                       ast::node const& node,
                       p::frontend_error_report report) const -> std::ostream&
     {
-      auto span_search = this->m_span_lookup.find(node.uuid);
-      if (span_search == this->m_span_lookup.end()) {
+      if (node.id >= this->m_span_lookup.size() || !this->m_span_lookup[node.id]) {
         os << "Unable to report error with span! AST Node is does not have an associated span\n";
         os << "Message: " << report.message << "\n";
       } else {
-        auto const& span = span_search->second;
+        auto const& span = *this->m_span_lookup[node.id];
         static constexpr auto opts = lexy::visualization_options {} | lexy::visualize_fancy;
 
         lexy_ext::diagnostic_writer(this->m_input, opts)
@@ -599,8 +619,10 @@ struct lexy_frontend
     }
 
   private:
+    // The input only views the source text, whose storage this keeps alive
     Input m_input;
     span_map m_span_lookup;
+    std::shared_ptr<void const> m_owner;
   };
 
   struct lexy_state
@@ -610,14 +632,22 @@ struct lexy_frontend
     {
     }
 
+    auto record_span(ast::node_id id, lexy_span span) -> void
+    {
+      if (id >= this->span_lookup.size()) {
+        this->span_lookup.resize(id + 1);
+      }
+      this->span_lookup[id] = std::move(span);
+    }
+
     Input& input;
     span_map span_lookup;
   };
 
-  static auto parse(std::string_view code) -> p::frontend_parse_result
+  static auto parse(p::source code) -> p::frontend_parse_result
   {
     using entrypoint = top_level<typename lexy_grammar<Input>::mod>;
-    return lexy_frontend<Input>::parse_entrypoint<entrypoint>(code);
+    return lexy_frontend<Input>::parse_entrypoint<entrypoint>(code.text, std::move(code.owner));
   }
 
   static auto parse_expression(std::string_view code) -> p::frontend_parse_result
@@ -634,18 +664,26 @@ struct lexy_frontend
 
 private:
   template<typename Entrypoint>
-  static auto parse_entrypoint(std::string_view code) -> p::frontend_parse_result
+  static auto parse_entrypoint(std::string_view code, std::shared_ptr<void const> owner = nullptr)
+      -> p::frontend_parse_result
   {
     auto input = Input {code};
     auto state = lexy_state {input};
 
+    // Number this tree's nodes densely from zero, so spans can be stored by index
+    ast::reset_node_ids();
+
+    // Nodes are placed into the arena, which is then handed over to the resulting tree
+    auto nodes = ast::arena {};
+    auto allocate_into = ast::arena_scope {nodes};
+
     std::string error;
     auto error_handling = lexy_ext::report_error.to(std::back_insert_iterator(error));
 
     if (auto tree = lexy::parse<Entrypoint>(input, state, error_handling); tree.is_success()) {
-      auto lexy_pr =
-          std::make_unique<lexy_parse_result>(std::move(input), std::move(state.span_lookup));
-      auto ast = std::move(tree).value();
+      auto ast = ast::tree {std::move(nodes), std::move(tree).value()};
+      auto lexy_pr = std::make_unique<lexy_parse_result>(
+          std::move(input), std::move(state.span_lookup), std::move(owner));
 
       return p::frontend_parse_result(std::move(lexy_pr), std::move(ast));
     }
@@ -659,8 +697,14 @@ namespace bython::parser
 
 auto lexy_code_frontend::parse(std::string_view code) -> frontend_parse_result
 {
+  return this->parse(source {code, nullptr});
+}
+
+auto lexy_code_frontend::parse(source code) -> frontend_parse_result
+{
+  // string_input only views the text, so a mapped file is parsed in place without being copied
   using parser = lexy_frontend<lexy::string_input<>>;
-  return parser::parse(code);
+  return parser::parse(std::move(code));
 }
 
 auto lexy_code_frontend::parse_expression(std::string_view code) -> frontend_parse_result
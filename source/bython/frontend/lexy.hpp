@@ -15,6 +15,7 @@ namespace bython::parser
 struct lexy_code_frontend final : frontend
 {
   virtual auto parse(std::string_view code) -> frontend_parse_result;
+  virtual auto parse(source code) -> frontend_parse_result;
   virtual auto parse_expression(std::string_view code) -> frontend_parse_result;
   virtual auto parse_statement(std::string_view code) -> frontend_parse_result;
 };
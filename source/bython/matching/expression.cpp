@@ -70,7 +70,7 @@ auto integer::matches(ast::node const& ast) const -> bool
 auto variable::matches(const ast::node& ast) const -> bool
 {
   if (auto const* var_ = ast::dyn_cast<ast::variable>(&ast)) {
-    return this->identifier == var_->identifier;
+    return this->identifier == ast::spelling(var_->identifier);
   }
 
   return false;
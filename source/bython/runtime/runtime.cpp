@@ -0,0 +1,83 @@
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+
+#include "runtime.hpp"
+
+namespace
+{
+class output_buffer
+{
+public:
+  output_buffer() = default;
+  output_buffer(output_buffer const&) = delete;
+  auto operator=(output_buffer const&) -> output_buffer& = delete;
+
+  ~output_buffer()
+  {
+    this->flush();
+  }
+
+  template<typename T, typename... Format>
+  auto put(T value, Format... format) -> void
+  {
+    if (this->data.size() - this->size < max_width) {
+      this->flush();
+    }
+
+    auto* first = this->data.data() + this->size;
+    auto [last, ec] = std::to_chars(first, this->data.data() + this->data.size(), value, format...);
+    this->size += static_cast<std::size_t>(last - first);
+  }
+
+  auto flush() -> void
+  {
+    if (this->size != 0) {
+      std::fwrite(this->data.data(), 1, this->size, stdout);
+      this->size = 0;
+    }
+    std::fflush(stdout);
+  }
+
+private:
+  // Longer than any formatted 64-bit integer or 6-digit floating point value
+  static constexpr auto max_width = std::size_t {32};
+
+  std::array<char, std::size_t {64} * 1024> data {};
+  std::size_t size = 0;
+};
+
+thread_local auto buffer = output_buffer {};
+
+// Matches the default iostream formatting of floating point values, i.e. printf's "%g"
+constexpr auto fp_precision = 6;
+}  // namespace
+
+extern "C"
+{
+auto put_i64(std::int64_t value) -> void
+{
+  buffer.put(value);
+}
+
+auto put_u64(std::uint64_t value) -> void
+{
+  buffer.put(value);
+}
+
+auto put_f32(float value) -> void
+{
+  buffer.put(value, std::chars_format::general, fp_precision);
+}
+
+auto put_f64(double value) -> void
+{
+  buffer.put(value, std::chars_format::general, fp_precision);
+}
+
+auto bython_flush() -> void
+{
+  buffer.flush();
+}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+/// Implementations of the language's put_* builtins. They have C linkage so that JIT'd code and
+/// ahead-of-time compiled executables both resolve them by their plain builtin names.
+///
+/// Output is collected in a per-thread buffer that is written to stdout when it fills up, when
+/// bython_flush is called, and when the thread exits.
+extern "C"
+{
+auto put_i64(std::int64_t value) -> void;
+auto put_u64(std::uint64_t value) -> void;
+auto put_f32(float value) -> void;
+auto put_f64(double value) -> void;
+
+auto bython_flush() -> void;
+}
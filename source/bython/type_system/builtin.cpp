@@ -1,8 +1,17 @@
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 
 #include "builtin.hpp"
 
+namespace
+{
+auto hash_combine(std::size_t seed, std::size_t value) -> std::size_t
+{
+  return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6U) + (seed >> 2U));
+}
+}  // namespace
+
 namespace bython::type_system
 {
 auto type::operator!=(type const& other) const -> bool
@@ -10,6 +19,11 @@ auto type::operator!=(type const& other) const -> bool
   return !(*this == other);
 }
 
+auto type::hash() const -> std::size_t
+{
+  return std::hash<type_tag> {}(this->tag());
+}
+
 auto void_::operator==(type const& other) const -> bool
 {
   return other.tag() == type_tag::void_;
@@ -36,6 +50,11 @@ auto uint::operator==(type const& other) const -> bool
   return other_uint != nullptr && this->width == other_uint->width;
 }
 
+auto uint::hash() const -> std::size_t
+{
+  return hash_combine(this->type::hash(), this->width);
+}
+
 sint::sint(unsigned width_)
     : width {width_}
 {
@@ -52,6 +71,11 @@ auto sint::operator==(type const& other) const -> bool
   return other_sint != nullptr && this->width == other_sint->width;
 }
 
+auto sint::hash() const -> std::size_t
+{
+  return hash_combine(this->type::hash(), this->width);
+}
+
 auto single_fp::tag() const -> type_tag
 {
   return type_tag::single_fp;
@@ -98,6 +122,16 @@ auto function_signature::operator==(type const& other) const -> bool
       && this->rettype == other_f->rettype;
 }
 
+auto function_signature::hash() const -> std::size_t
+{
+  // Parameter and return types are interned, so their addresses identify them
+  auto seed = hash_combine(this->type::hash(), std::hash<type*> {}(this->rettype));
+  for (auto* parameter : this->parameters) {
+    seed = hash_combine(seed, std::hash<type*> {}(parameter));
+  }
+  return seed;
+}
+
 auto function_signature::tag() const -> type_tag
 {
   return type_tag::function;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -32,6 +33,9 @@ struct type
   virtual auto operator==(type const& other) const -> bool = 0;
   virtual auto operator!=(type const& other) const -> bool final;
 
+  /// Structural hash, consistent with operator==
+  virtual auto hash() const -> std::size_t;
+
   virtual auto tag() const -> type_tag = 0;
 };
 
@@ -48,6 +52,7 @@ struct uint final : type
 
   unsigned width;
   auto operator==(type const& other) const -> bool;
+  auto hash() const -> std::size_t;
 
   auto tag() const -> type_tag;
 };
@@ -58,6 +63,7 @@ struct sint final : type
 
   unsigned width;
   auto operator==(type const& other) const -> bool;
+  auto hash() const -> std::size_t;
 
   auto tag() const -> type_tag;
 };
@@ -91,6 +97,7 @@ struct function_signature final : type
   type* rettype;
 
   auto operator==(type const& other) const -> bool;
+  auto hash() const -> std::size_t;
   auto tag() const -> type_tag;
 };
 
@@ -1,13 +1,13 @@
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "environment.hpp"
 
-#include <boost/uuid/uuid_io.hpp>
-
 #include "builtin.hpp"
 #include "bython/ast.hpp"
 #include "bython/ast/statement.hpp"
@@ -23,59 +23,73 @@ auto environment::initialise_with_builtins() -> environment
 
   /// Types
   // void / unit
-  [[maybe_unused]] auto voidt_ = env.add_new_named_type("void", std::make_unique<void_>());
+  [[maybe_unused]] auto voidt_ =
+      env.add_new_named_type(ast::symbols::void_, std::make_unique<void_>());
 
   // boolean
-  [[maybe_unused]] auto bool_ = env.add_new_named_type("bool", std::make_unique<boolean>());
+  [[maybe_unused]] auto bool_ =
+      env.add_new_named_type(ast::symbols::bool_, std::make_unique<boolean>());
 
   // uint{8, 16, 32, 64}_t
-  [[maybe_unused]] auto u8 = env.add_new_named_type("u8", std::make_unique<uint>(8));
-  [[maybe_unused]] auto u16 = env.add_new_named_type("u16", std::make_unique<uint>(16));
-  [[maybe_unused]] auto u32 = env.add_new_named_type("u32", std::make_unique<uint>(32));
-  [[maybe_unused]] auto u64 = env.add_new_named_type("u64", std::make_unique<uint>(64));
+  [[maybe_unused]] auto u8 = env.add_new_named_type(ast::symbols::u8, std::make_unique<uint>(8));
+  [[maybe_unused]] auto u16 = env.add_new_named_type(ast::symbols::u16, std::make_unique<uint>(16));
+  [[maybe_unused]] auto u32 = env.add_new_named_type(ast::symbols::u32, std::make_unique<uint>(32));
+  [[maybe_unused]] auto u64 = env.add_new_named_type(ast::symbols::u64, std::make_unique<uint>(64));
 
   // int{8, 16, 32, 64}_t
-  [[maybe_unused]] auto i8 = env.add_new_named_type("i8", std::make_unique<sint>(8));
-  [[maybe_unused]] auto i16 = env.add_new_named_type("i16", std::make_unique<sint>(16));
-  [[maybe_unused]] auto i32 = env.add_new_named_type("i32", std::make_unique<sint>(32));
-  [[maybe_unused]] auto i64 = env.add_new_named_type("i64", std::make_unique<sint>(64));
+  [[maybe_unused]] auto i8 = env.add_new_named_type(ast::symbols::i8, std::make_unique<sint>(8));
+  [[maybe_unused]] auto i16 = env.add_new_named_type(ast::symbols::i16, std::make_unique<sint>(16));
+  [[maybe_unused]] auto i32 = env.add_new_named_type(ast::symbols::i32, std::make_unique<sint>(32));
+  [[maybe_unused]] auto i64 = env.add_new_named_type(ast::symbols::i64, std::make_unique<sint>(64));
 
   // f{32, 64}
-  [[maybe_unused]] auto f32 = env.add_new_named_type("f32", std::make_unique<single_fp>());
-  [[maybe_unused]] auto f64 = env.add_new_named_type("f64", std::make_unique<double_fp>());
+  [[maybe_unused]] auto f32 =
+      env.add_new_named_type(ast::symbols::f32, std::make_unique<single_fp>());
+  [[maybe_unused]] auto f64 =
+      env.add_new_named_type(ast::symbols::f64, std::make_unique<double_fp>());
 
   /// Functions
   auto put_i64_ft =
       env.add_unnamed_type(std::make_unique<function_signature>(std::vector {i64}, voidt_));
-  env.add_new_symbol("put_i64", put_i64_ft);
+  env.add_new_symbol(ast::symbols::put_i64, put_i64_ft);
 
   auto put_u64_ft =
       env.add_unnamed_type(std::make_unique<function_signature>(std::vector {u64}, voidt_));
-  env.add_new_symbol("put_u64", put_u64_ft);
+  env.add_new_symbol(ast::symbols::put_u64, put_u64_ft);
 
   auto put_f32_ft =
       env.add_unnamed_type(std::make_unique<function_signature>(std::vector {f32}, voidt_));
-  env.add_new_symbol("put_f32", put_f32_ft);
+  env.add_new_symbol(ast::symbols::put_f32, put_f32_ft);
 
   auto put_f64_ft =
       env.add_unnamed_type(std::make_unique<function_signature>(std::vector {f32}, voidt_));
-  env.add_new_symbol("put_f64", put_f64_ft);
+  env.add_new_symbol(ast::symbols::put_f64, put_f64_ft);
 
   return env;
 }
 
-auto environment::add_new_named_type(std::string tname, std::unique_ptr<type> type)
+auto environment::add_new_named_type(ast::symbol tname, std::unique_ptr<type> type)
     -> type_system::type*
 {
-  auto&& [inserted, _] = this->m_visible_types.emplace(std::move(type));
-  this->m_typename_to_typeptr.emplace(std::move(tname), inserted->get());
-  return inserted->get();
+  auto* interned = this->add_unnamed_type(std::move(type));
+  this->m_typename_to_typeptr.emplace(tname, interned);
+  return interned;
 }
 
 auto environment::add_unnamed_type(std::unique_ptr<type> type) -> type_system::type*
 {
-  auto&& [inserted, _] = this->m_visible_types.emplace(std::move(type));
-  return inserted->get();
+  // A structurally equal type that is already known is reused and `type` is dropped
+  auto&& [interned, _] = this->m_visible_types.insert(std::move(type));
+  return interned->get();
+}
+
+auto environment::find_type(type_system::type const& type) const
+    -> std::optional<type_system::type*>
+{
+  if (auto it = this->m_visible_types.find(type); it != this->m_visible_types.end()) {
+    return it->get();
+  }
+  return std::nullopt;
 }
 
 auto environment::add_new_function_type(ast::signature const& signature)
@@ -99,37 +113,103 @@ auto environment::add_new_function_type(ast::signature const& signature)
     }
     rettype = *rettype_ts;
   } else {
-    rettype = this->lookup_type("void").value();
+    rettype = this->lookup_type(ast::symbols::void_).value();
+  }
+
+  // Functions sharing a signature share its type, so only allocate signatures not seen before
+  auto candidate = type_system::function_signature {std::move(parameters), rettype};
+  auto* added_ft = this->find_type(candidate).value_or(nullptr);
+  if (added_ft == nullptr) {
+    added_ft = this->add_unnamed_type(
+        std::make_unique<type_system::function_signature>(std::move(candidate)));
   }
 
-  auto added_ft = this->add_new_named_type(
-      signature.name,  // TODO: This is likely unsound, reconsinder "uniqueness"
-      std::make_unique<type_system::function_signature>(std::move(parameters), rettype));
-  return std::make_optional(dynamic_cast<type_system::function_signature*>(added_ft));
+  // TODO: This is likely unsound, reconsinder "uniqueness"
+  this->m_typename_to_typeptr.emplace(signature.name, added_ft);
+  return std::make_optional(static_cast<type_system::function_signature*>(added_ft));
 }
 
-auto environment::lookup_type(std::string_view tname) const -> std::optional<type_system::type*>
+auto environment::lookup_type(ast::symbol tname) const -> std::optional<type_system::type*>
 {
-  if (auto it = this->m_typename_to_typeptr.find(tname); it != this->m_typename_to_typeptr.end()) {
-    return it->second;
+  if (auto const* found = this->m_typename_to_typeptr.find(tname); found != nullptr) {
+    return *found;
   }
   return std::nullopt;
 }
 
-auto environment::add_new_symbol(std::string sname, type_system::type* type) -> void
+auto environment::lookup_type(std::string_view tname) const -> std::optional<type_system::type*>
+{
+  return this->lookup_type(ast::intern(tname));
+}
+
+auto environment::add_new_symbol(ast::symbol sname, type_system::type* type) -> void
 {
-  this->m_symbol_to_ts.emplace(sname, type);
+  if (this->m_local_scopes.empty()) {
+    this->m_symbol_to_ts.emplace(sname, type);
+    return;
+  }
+
+  auto depth = this->m_local_scopes.size();
+  auto* chain = this->m_local_bindings.find(sname);
+  if (chain == nullptr) {
+    chain = &this->m_local_bindings.insert_or_assign(sname, {});
+  }
+
+  // As in codegen, rebinding within the same scope replaces the binding rather than shadowing it
+  if (!chain->empty() && chain->back().depth == depth) {
+    chain->back().type = type;
+    return;
+  }
+
+  chain->push_back(local_binding {.type = type, .depth = depth});
+  this->m_local_scopes.back().push_back(sname);
 }
 
-auto environment::lookup_symbol(std::string_view symbol_name) const
-    -> std::optional<type_system::type*>
+auto environment::push_scope() -> void
 {
-  if (auto it = this->m_symbol_to_ts.find(symbol_name); it != this->m_symbol_to_ts.end()) {
-    return it->second;
+  this->m_local_scopes.emplace_back();
+}
+
+auto environment::pop_scope() -> void
+{
+  assert(!this->m_local_scopes.empty() && "Popped the global scope");
+  for (auto sname : this->m_local_scopes.back()) {
+    this->m_local_bindings.find(sname)->pop_back();
+  }
+  this->m_local_scopes.pop_back();
+}
+
+auto environment::symbols() const -> ast::symbol_map<type_system::type*> const&
+{
+  assert(this->m_local_scopes.empty() && "Local bindings are not part of the snapshot");
+  return this->m_symbol_to_ts;
+}
+
+auto environment::restore_symbols(ast::symbol_map<type_system::type*> symbols) -> void
+{
+  assert(this->m_local_scopes.empty() && "Local bindings are not part of the snapshot");
+  this->m_symbol_to_ts = std::move(symbols);
+}
+
+auto environment::lookup_symbol(ast::symbol symbol_name) const -> std::optional<type_system::type*>
+{
+  if (auto const* chain = this->m_local_bindings.find(symbol_name);
+      chain != nullptr && !chain->empty())
+  {
+    return chain->back().type;
+  }
+  if (auto const* found = this->m_symbol_to_ts.find(symbol_name); found != nullptr) {
+    return *found;
   }
   return std::nullopt;
 }
 
+auto environment::lookup_symbol(std::string_view symbol_name) const
+    -> std::optional<type_system::type*>
+{
+  return this->lookup_symbol(ast::intern(symbol_name));
+}
+
 auto environment::try_subtype(type_system::type const& tau, type_system::type const& alpha) const
     -> std::optional<type_system::subtyping_rule>
 {
@@ -141,4 +221,9 @@ auto environment::get_type(ast::expression const& expr) const -> std::optional<t
   return try_infer_impl(expr, *this);
 }
 
+auto environment::annotate(ast::node const& ast) -> type_system::typed_ast
+{
+  return try_annotate_impl(ast, *this);
+}
+
 }  // namespace bython::type_system
\ No newline at end of file
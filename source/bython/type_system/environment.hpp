@@ -1,46 +1,119 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
-#include <boost/uuid/uuid.hpp>
-
 #include "builtin.hpp"
 #include "bython/ast/expression.hpp"
 #include "bython/ast/statement.hpp"
+#include "bython/ast/symbol.hpp"
+#include "bython/ast/symbol_map.hpp"
 #include "bython/type_system/subtyping.hpp"
+#include "bython/type_system/typed_ast.hpp"
 
 namespace bython::type_system
 {
+/// Hashes and compares types by structure, so that the type arena can be queried with a candidate
+/// type before it is allocated
+struct structural_hash
+{
+  using is_transparent = void;
+
+  auto operator()(type const& type) const -> std::size_t
+  {
+    return type.hash();
+  }
+
+  auto operator()(std::unique_ptr<type> const& type) const -> std::size_t
+  {
+    return type->hash();
+  }
+};
+
+struct structural_equal
+{
+  using is_transparent = void;
+
+  template<typename Lhs, typename Rhs>
+  auto operator()(Lhs const& lhs, Rhs const& rhs) const -> bool
+  {
+    return deref(lhs) == deref(rhs);
+  }
+
+private:
+  static auto deref(type const& type) -> type_system::type const&
+  {
+    return type;
+  }
+
+  static auto deref(std::unique_ptr<type> const& type) -> type_system::type const&
+  {
+    return *type;
+  }
+};
+
 class environment
 {
-  std::unordered_set<std::unique_ptr<type_system::type>> m_visible_types;
-  std::map<std::string, type_system::type*, std::less<>> m_typename_to_typeptr;
+  // Every type is interned: the arena holds one object per distinct type, and types can be
+  // compared by address
+  std::unordered_set<std::unique_ptr<type_system::type>, structural_hash, structural_equal>
+      m_visible_types;
+  ast::symbol_map<type_system::type*> m_typename_to_typeptr;
+
+  // Bindings made outside of any function, which stay visible for the environment's lifetime
+  ast::symbol_map<type_system::type*> m_symbol_to_ts;
+
+  struct local_binding
+  {
+    type_system::type* type;
+    std::size_t depth;
+  };
 
-  std::map<std::string, type_system::type*, std::less<>> m_symbol_to_ts;
+  // Scope chain of the bindings made in function and branch bodies, laid out like
+  // `backend::stack`: every symbol maps to its own stack of bindings, innermost last
+  ast::symbol_map<std::vector<local_binding>> m_local_bindings;
+  std::vector<std::vector<ast::symbol>> m_local_scopes;
 
 public:
   static auto initialise_with_builtins() -> environment;
 
-  auto add_new_symbol(std::string sname, type_system::type* type) -> void;
-  auto add_new_named_type(std::string tname, std::unique_ptr<type_system::type> type)
+  /// Binds `sname` in the innermost open scope, or globally when no scope is open
+  auto add_new_symbol(ast::symbol sname, type_system::type* type) -> void;
+  auto add_new_named_type(ast::symbol tname, std::unique_ptr<type_system::type> type)
       -> type_system::type*;
   auto add_new_function_type(ast::signature const& signature)
       -> std::optional<type_system::function_signature*>;
 
+  auto lookup_type(ast::symbol tname) const -> std::optional<type_system::type*>;
+  auto lookup_symbol(ast::symbol symbol_name) const -> std::optional<type_system::type*>;
+
+  /// Convenience overloads that intern `tname` / `symbol_name` first
   auto lookup_type(std::string_view tname) const -> std::optional<type_system::type*>;
   auto lookup_symbol(std::string_view symbol_name) const -> std::optional<type_system::type*>;
 
+  /// Opens and closes a scope for the bindings of a function or branch body
+  auto push_scope() -> void;
+  auto pop_scope() -> void;
+
   auto get_type(ast::expression const& expr) const -> std::optional<type_system::type*>;
 
+  /// Registers the functions and bindings of `ast` and infers every expression within it once
+  auto annotate(ast::node const& ast) -> type_system::typed_ast;
+
+  /// The global symbols registered so far. Passing them back to `restore_symbols` undoes every
+  /// registration made in between, such as those of an input that failed to compile.
+  auto symbols() const -> ast::symbol_map<type_system::type*> const&;
+  auto restore_symbols(ast::symbol_map<type_system::type*> symbols) -> void;
+
   auto try_subtype(type_system::type const& tau, type_system::type const& alpha) const
       -> std::optional<type_system::subtyping_rule>;
 
   private:
     auto add_unnamed_type(std::unique_ptr<type_system::type> type) -> type_system::type*;
+    auto find_type(type_system::type const& type) const -> std::optional<type_system::type*>;
 };
 }  // namespace bython::type_system
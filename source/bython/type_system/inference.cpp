@@ -35,21 +35,40 @@ namespace ts = bython::type_system;
 
 struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
 {
-  explicit inference_visitor(ts::environment const& environment)
+  explicit inference_visitor(ts::environment const& environment, ts::typed_ast* memo_ = nullptr)
       : env {environment}
+      , memo {memo_}
   {
   }
 
+  /// Infers each expression at most once when a side-table is attached
+  auto infer(expression const& expr) -> std::optional<ts::type*>
+  {
+    if (this->memo == nullptr) {
+      return this->visit(expr);
+    }
+
+    if (auto known = this->memo->type_of(expr)) {
+      return known;
+    }
+
+    auto inferred = this->visit(expr);
+    if (inferred) {
+      this->memo->annotate(expr, inferred.value());
+    }
+    return inferred;
+  }
+
   BYTHON_VISITOR_IMPL(unary_operation, unop)
   {
-    auto rhs_type = this->visit(*unop.rhs);
+    auto rhs_type = this->infer(*unop.rhs);
     return rhs_type;
     // if (!rhs_type) { return std::nullopt; }
   }
 
   BYTHON_VISITOR_IMPL(binary_operation, binop)
   {
-    auto lhs_type = this->visit(*binop.lhs);
+    auto lhs_type = this->infer(*binop.lhs);
     if (!lhs_type) {
       return std::nullopt;
     }
@@ -58,7 +77,7 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
     std::optional<ts::type*> rhs_type = std::nullopt;
     std::optional<ts::type_tag> rhs_tag = std::nullopt;
     if (binop.op.op != binop_tag::as) {
-      if (rhs_type = this->visit(*binop.rhs); !rhs_type) {
+      if (rhs_type = this->infer(*binop.rhs); !rhs_type) {
         return std::nullopt;
       }
       rhs_tag = rhs_type.value()->tag();
@@ -74,7 +93,7 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
 
       case binop_tag::pow: {
         // Implemented using llvm.pow.f32; return type is known to be f32
-        return this->env.lookup_type("f32");
+        return this->env.lookup_type(symbols::f32);
       }
       case binop_tag::multiply:
       case binop_tag::divide:
@@ -126,7 +145,7 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
       }
       case binop_tag::booland:
       case binop_tag::boolor:
-        return this->env.lookup_type("bool").value();
+        return this->env.lookup_type(symbols::bool_).value();
     }
 
     return std::nullopt;
@@ -134,18 +153,18 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
 
   BYTHON_VISITOR_IMPL(comparison, instance)
   {
-    auto lhs = this->visit(*instance.lhs);
+    auto lhs = this->infer(*instance.lhs);
     if (!lhs) {
       return std::nullopt;
     }
-    auto rhs = this->visit(*instance.rhs);
+    auto rhs = this->infer(*instance.rhs);
     if (!rhs) {
       return std::nullopt;
     }
     if (ts::try_subtype_impl(*lhs.value(), *rhs.value())
         || ts::try_subtype_impl(*rhs.value(), *lhs.value()))
     {
-      return this->env.lookup_type("bool");
+      return this->env.lookup_type(symbols::bool_);
     }
     return std::nullopt;
   }
@@ -155,22 +174,22 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
     if (std::numeric_limits<std::uint8_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::uint8_t>::max())
     {
-      return this->env.lookup_type("u8");
+      return this->env.lookup_type(symbols::u8);
     }
 
     if (std::numeric_limits<std::uint16_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::uint16_t>::max())
     {
-      return this->env.lookup_type("u16");
+      return this->env.lookup_type(symbols::u16);
     }
 
     if (std::numeric_limits<std::uint32_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::uint32_t>::max())
     {
-      return this->env.lookup_type("u32");
+      return this->env.lookup_type(symbols::u32);
     }
 
-    return this->env.lookup_type("u64");
+    return this->env.lookup_type(symbols::u64);
   }
 
   BYTHON_VISITOR_IMPL(signed_integer, instance)
@@ -178,26 +197,35 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
     if (std::numeric_limits<std::int8_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::int8_t>::max())
     {
-      return this->env.lookup_type("i8");
+      return this->env.lookup_type(symbols::i8);
     }
 
     if (std::numeric_limits<std::int16_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::int16_t>::max())
     {
-      return this->env.lookup_type("i16");
+      return this->env.lookup_type(symbols::i16);
     }
 
     if (std::numeric_limits<std::int32_t>::lowest() <= instance.value
         && instance.value <= std::numeric_limits<std::int32_t>::max())
     {
-      return this->env.lookup_type("i32");
+      return this->env.lookup_type(symbols::i32);
     }
 
-    return this->env.lookup_type("i64");
+    return this->env.lookup_type(symbols::i64);
+  }
+
+  BYTHON_VISITOR_IMPL(boolean, /*instance*/)
+  {
+    return this->env.lookup_type(symbols::bool_);
   }
 
   BYTHON_VISITOR_IMPL(call, instance)
   {
+    for (auto&& argument : instance.arguments.arguments) {
+      [[maybe_unused]] auto argument_type = this->infer(*argument);
+    }
+
     auto symbol_type = this->env.lookup_symbol(instance.callee);
     if (!symbol_type) {
       return std::nullopt;
@@ -219,6 +247,103 @@ struct inference_visitor : visitor<inference_visitor, std::optional<ts::type*>>
   }
 
   ts::environment const& env;
+  ts::typed_ast* memo;
+};
+
+/// Walks statements in program order, registering functions and let-bindings with the
+/// environment so that every expression is inferred exactly once into the side-table
+struct annotation_visitor : visitor<annotation_visitor>
+{
+  explicit annotation_visitor(ts::environment& environment)
+      : env {environment}
+      , inference {environment, &types}
+  {
+  }
+
+  BYTHON_VISITOR_IMPL(mod, m)
+  {
+    this->visit_body(m.body);
+  }
+
+  BYTHON_VISITOR_IMPL(function_def, fdef)
+  {
+    if (auto function_type = this->env.add_new_function_type(fdef.sig)) {
+      this->env.add_new_symbol(fdef.sig.name, function_type.value());
+    }
+    this->visit_scoped_body(fdef.body);
+  }
+
+  BYTHON_VISITOR_IMPL(let_assignment, assgn)
+  {
+    this->visit(*assgn.rhs);
+    if (auto lhs_type = this->env.lookup_type(assgn.hint)) {
+      this->env.add_new_symbol(assgn.lhs, lhs_type.value());
+    }
+  }
+
+  BYTHON_VISITOR_IMPL(expression_statement, instance)
+  {
+    this->visit(*instance.discarded);
+  }
+
+  BYTHON_VISITOR_IMPL(return_, instance)
+  {
+    this->visit(*instance.expr);
+  }
+
+  BYTHON_VISITOR_IMPL(conditional_branch, instance)
+  {
+    this->visit(*instance.condition);
+    this->visit_scoped_body(instance.body);
+    if (instance.orelse != nullptr) {
+      this->visit(*instance.orelse);
+    }
+  }
+
+  BYTHON_VISITOR_IMPL(unconditional_branch, instance)
+  {
+    this->visit_scoped_body(instance.body);
+  }
+
+  BYTHON_VISITOR_IMPL(for_, instance)
+  {
+    this->visit_body(instance.body);
+  }
+
+  BYTHON_VISITOR_IMPL(while_, instance)
+  {
+    this->visit_body(instance.body);
+  }
+
+  BYTHON_VISITOR_IMPL(expression, expr)
+  {
+    [[maybe_unused]] auto expr_type = this->inference.infer(expr);
+  }
+
+  BYTHON_VISITOR_IMPL(node, /*instance*/)
+  {
+    // Nodes without expressions (e.g. type definitions) carry nothing to annotate
+  }
+
+  ts::environment& env;
+  ts::typed_ast types;
+  inference_visitor inference;
+
+private:
+  auto visit_body(statements const& body) -> void
+  {
+    for (auto&& stmt : body) {
+      this->visit(*stmt);
+    }
+  }
+
+  // Bindings made in a function or branch body are not visible once it ends, as in codegen
+  auto visit_scoped_body(statements const& body) -> void
+  {
+    this->env.push_scope();
+    this->visit_body(body);
+    this->env.pop_scope();
+  }
 };
 }  // namespace
 
@@ -230,4 +355,12 @@ auto try_infer_impl(ast::expression const& expr, type_system::environment const&
   auto visitor = inference_visitor {environment};
   return visitor.visit(expr);
 }
+
+auto try_annotate_impl(ast::node const& ast, type_system::environment& environment)
+    -> type_system::typed_ast
+{
+  auto visitor = annotation_visitor {environment};
+  visitor.visit(ast);
+  return std::move(visitor.types);
+}
 }  // namespace bython::type_system
\ No newline at end of file
@@ -3,14 +3,16 @@
 #include <map>
 #include <optional>
 
-#include <boost/uuid/uuid.hpp>
-
 #include "builtin.hpp"
 #include "bython/ast/expression.hpp"
 #include "environment.hpp"
+#include "typed_ast.hpp"
 
 namespace bython::type_system
 {
 auto try_infer_impl(ast::expression const& expr, type_system::environment const& environment)
     -> std::optional<type_system::type*>;
+
+auto try_annotate_impl(ast::node const& ast, type_system::environment& environment)
+    -> type_system::typed_ast;
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include <array>
 #include <cstddef>
-#include <memory>
 #include <optional>
 
 #include "subtyping.hpp"
@@ -11,190 +10,216 @@ namespace
 {
 namespace ts = bython::type_system;
 
-struct subtype_rule
+/// The builtin types that take part in subtyping, each one a row and column of the subtyping matrix
+struct builtin_kind
 {
-  virtual ~subtype_rule() = default;
-  virtual auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule> = 0;
+  ts::type_tag tag;
+  unsigned width;
 };
 
-/**
- * \tau <: \tau
- */
-struct identity_rule final : subtype_rule
+constexpr auto builtin_kinds = std::array {
+    builtin_kind {ts::type_tag::void_, 0},
+    builtin_kind {ts::type_tag::boolean, 1},
+    builtin_kind {ts::type_tag::uint, 8},
+    builtin_kind {ts::type_tag::uint, 16},
+    builtin_kind {ts::type_tag::uint, 32},
+    builtin_kind {ts::type_tag::uint, 64},
+    builtin_kind {ts::type_tag::sint, 8},
+    builtin_kind {ts::type_tag::sint, 16},
+    builtin_kind {ts::type_tag::sint, 32},
+    builtin_kind {ts::type_tag::sint, 64},
+    builtin_kind {ts::type_tag::single_fp, 32},
+    builtin_kind {ts::type_tag::double_fp, 64},
+};
+
+constexpr auto is_integer(ts::type_tag tag) -> bool
 {
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    if (tau != alpha) {
-      return std::nullopt;
-    }
+  return tag == ts::type_tag::uint || tag == ts::type_tag::sint;
+}
+
+constexpr auto is_floating_point(ts::type_tag tag) -> bool
+{
+  return tag == ts::type_tag::single_fp || tag == ts::type_tag::double_fp;
+}
 
+/// The subtyping rules, tried in order of precedence
+constexpr auto derive_rule(builtin_kind tau, builtin_kind alpha)
+    -> std::optional<ts::subtyping_rule>
+{
+  // \tau <: \tau
+  if (tau.tag == alpha.tag && tau.width == alpha.width) {
     return ts::subtyping_rule::identity;
   }
-} const identity;
 
-/**
- * \eSInt <: \eBiggerSInt
- * \eUInt <: \eBiggerUInt
- */
-struct integer_promotion_rule final : subtype_rule
-{
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    if (tau.tag() == ts::type_tag::sint && alpha.tag() == ts::type_tag::sint) {
-      auto const& tau_sint = dynamic_cast<ts::sint const&>(tau);
-      auto const& alpha_sint = dynamic_cast<ts::sint const&>(alpha);
-
-      if (tau_sint.width < alpha_sint.width) {
-        return ts::subtyping_rule::sint_promotion;
-      }
-    }
+  // \eSInt <: \eBiggerSInt
+  // \eUInt <: \eBiggerUInt
+  if (tau.tag == alpha.tag && is_integer(tau.tag) && tau.width < alpha.width) {
+    return tau.tag == ts::type_tag::sint ? ts::subtyping_rule::sint_promotion
+                                         : ts::subtyping_rule::uint_promotion;
+  }
 
-    else if (tau.tag() == ts::type_tag::uint && alpha.tag() == ts::type_tag::uint)
-    {
-      auto const& tau_uint = dynamic_cast<ts::uint const&>(tau);
-      auto const& alpha_uint = dynamic_cast<ts::uint const&>(alpha);
+  // \eF32 <: \eF64
+  if (tau.tag == ts::type_tag::single_fp && alpha.tag == ts::type_tag::double_fp) {
+    return ts::subtyping_rule::single_to_double;
+  }
 
-      if (tau_uint.width < alpha_uint.width) {
-        return ts::subtyping_rule::uint_promotion;
-      }
+  // \e{S,U}Int <: \eF{32,64}
+  if (is_integer(tau.tag) && is_floating_point(alpha.tag)) {
+    auto const to_single = alpha.tag == ts::type_tag::single_fp;
+    if (tau.tag == ts::type_tag::uint) {
+      return to_single ? ts::subtyping_rule::uint_to_single : ts::subtyping_rule::uint_to_double;
     }
+    return to_single ? ts::subtyping_rule::sint_to_single : ts::subtyping_rule::sint_to_double;
+  }
 
-    return std::nullopt;
+  // \e{SInt, UInt, F32, F64} <: \ebool
+  if (alpha.tag == ts::type_tag::boolean && tau.tag != ts::type_tag::void_) {
+    return ts::subtyping_rule::numeric_to_bool;
   }
-} const integer_promotion;
 
-/**
- * \e{S,U}Int <: \eF{32,64}
- */
-struct integer_to_floating_point_rule final : subtype_rule
-{
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    auto taut = tau.tag();
-    auto alphat = alpha.tag();
-
-    if (taut == ts::type_tag::uint && alphat == ts::type_tag::single_fp) {
-      return ts::subtyping_rule::uint_to_single;
-    }
-    if (taut == ts::type_tag::uint && alphat == ts::type_tag::double_fp) {
-      return ts::subtyping_rule::uint_to_double;
-    }
-    if (taut == ts::type_tag::sint && alphat == ts::type_tag::single_fp) {
-      return ts::subtyping_rule::sint_to_single;
-    }
-    if (taut == ts::type_tag::sint && alphat == ts::type_tag::double_fp) {
-      return ts::subtyping_rule::sint_to_double;
-    }
+  // \ebool <: \e{SInt, UInt}
+  if (tau.tag == ts::type_tag::boolean && is_integer(alpha.tag)) {
+    return ts::subtyping_rule::bool_int_prom;
+  }
 
-    return std::nullopt;
+  // \ebool <: \e{F32, F64}
+  if (tau.tag == ts::type_tag::boolean && is_floating_point(alpha.tag)) {
+    return ts::subtyping_rule::bool_fp_prom;
   }
-} const integer2floating_point;
 
-/**
- * \eF32 <: \eF64
- */
-struct fp_promotion_rule final : subtype_rule
+  return std::nullopt;
+}
+
+using subtyping_row = std::array<std::optional<ts::subtyping_rule>, builtin_kinds.size()>;
+
+constexpr auto subtyping_matrix = []
 {
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    auto taut = tau.tag();
-    auto alphat = alpha.tag();
-
-    if (taut == ts::type_tag::single_fp && alphat == ts::type_tag::double_fp) {
-      return ts::subtyping_rule::single_to_double;
+  auto matrix = std::array<subtyping_row, builtin_kinds.size()> {};
+  for (auto tau = std::size_t {0}; tau < builtin_kinds.size(); ++tau) {
+    for (auto alpha = std::size_t {0}; alpha < builtin_kinds.size(); ++alpha) {
+      matrix[tau][alpha] = derive_rule(builtin_kinds[tau], builtin_kinds[alpha]);
     }
-
-    return std::nullopt;
   }
-} const fp_promotion;
+  return matrix;
+}();
 
-/**
- * \e{SInt, UInt, F32, F64} <: \ebool
- */
-struct numeric_to_bool_rule final : subtype_rule
+/// Row and column of the first builtin kind tagged `tag`
+constexpr auto first_index(ts::type_tag tag) -> std::size_t
 {
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    auto taut = tau.tag();
-    auto alphat = alpha.tag();
-
-    if (alphat != ts::type_tag::boolean || taut == ts::type_tag::void_) {
-      return std::nullopt;
+  for (auto index = std::size_t {0}; index < builtin_kinds.size(); ++index) {
+    if (builtin_kinds[index].tag == tag) {
+      return index;
     }
-
-    return ts::subtyping_rule::numeric_to_bool;
   }
-} const number2bool;
+  return builtin_kinds.size();
+}
+
+constexpr auto void_index = first_index(ts::type_tag::void_);
+constexpr auto boolean_index = first_index(ts::type_tag::boolean);
+constexpr auto uint_index = first_index(ts::type_tag::uint);
+constexpr auto sint_index = first_index(ts::type_tag::sint);
+constexpr auto single_fp_index = first_index(ts::type_tag::single_fp);
+constexpr auto double_fp_index = first_index(ts::type_tag::double_fp);
 
-/**
- * \ebool <: \e{SInt, UInt}
- */
-struct bool_to_int_rule final : subtype_rule
+/// Whether the integers tagged `tag` are laid out as 8, 16, 32 and 64 bits from `first` onwards,
+/// as `integer_index` expects
+constexpr auto has_integer_run(std::size_t first, ts::type_tag tag) -> bool
 {
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    auto taut = tau.tag();
-    auto alphat = alpha.tag();
-
-    if (taut == ts::type_tag::boolean
-        && (alphat == ts::type_tag::sint || alphat == ts::type_tag::uint))
+  auto width = 8U;
+  for (auto index = first; index < first + 4; ++index, width *= 2) {
+    if (index >= builtin_kinds.size() || builtin_kinds[index].tag != tag
+        || builtin_kinds[index].width != width)
     {
-      return ts::subtyping_rule::bool_int_prom;
+      return false;
     }
-
-    return std::nullopt;
   }
-} const bool2int;
+  return true;
+}
+
+static_assert(void_index < builtin_kinds.size() && boolean_index < builtin_kinds.size()
+              && single_fp_index < builtin_kinds.size() && double_fp_index < builtin_kinds.size());
+static_assert(has_integer_run(uint_index, ts::type_tag::uint));
+static_assert(has_integer_run(sint_index, ts::type_tag::sint));
 
-/**
- * \ebool <: \e{F32, F64}
- */
-struct bool_to_fp_rule final : subtype_rule
+// i8 <: i64, but not the other way around
+static_assert(subtyping_matrix[sint_index][sint_index + 3] == ts::subtyping_rule::sint_promotion);
+static_assert(!subtyping_matrix[sint_index + 3][sint_index]);
+static_assert(subtyping_matrix[boolean_index][boolean_index] == ts::subtyping_rule::identity);
+
+/// Row and column of an integer of `width` bits, counting from the 8-bit integer at `first`
+constexpr auto integer_index(std::size_t first, unsigned width) -> std::optional<std::size_t>
 {
-  auto try_subtype(ts::type const& tau, ts::type const& alpha) const
-      -> std::optional<ts::subtyping_rule>
-  {
-    auto taut = tau.tag();
-    auto alphat = alpha.tag();
-
-    if (taut == ts::type_tag::boolean
-        && (alphat == ts::type_tag::single_fp || alphat == ts::type_tag::double_fp))
-    {
-      return ts::subtyping_rule::bool_fp_prom;
-    }
+  switch (width) {
+    case 8:
+      return first;
+    case 16:
+      return first + 1;
+    case 32:
+      return first + 2;
+    case 64:
+      return first + 3;
+    default:
+      return std::nullopt;
+  }
+}
 
-    return std::nullopt;
+auto kind_of(ts::type const& type) -> builtin_kind
+{
+  switch (type.tag()) {
+    case ts::type_tag::uint:
+      return {ts::type_tag::uint, static_cast<ts::uint const&>(type).width};
+    case ts::type_tag::sint:
+      return {ts::type_tag::sint, static_cast<ts::sint const&>(type).width};
+    default:
+      return {type.tag(), 0};
   }
-} const bool2fp;
+}
 
+/// Position of a builtin type in `builtin_kinds`, if it has one
+auto matrix_index(builtin_kind kind) -> std::optional<std::size_t>
+{
+  switch (kind.tag) {
+    case ts::type_tag::void_:
+      return void_index;
+    case ts::type_tag::boolean:
+      return boolean_index;
+    case ts::type_tag::uint:
+      return integer_index(uint_index, kind.width);
+    case ts::type_tag::sint:
+      return integer_index(sint_index, kind.width);
+    case ts::type_tag::single_fp:
+      return single_fp_index;
+    case ts::type_tag::double_fp:
+      return double_fp_index;
+    case ts::type_tag::function:
+      return std::nullopt;
+  }
+  return std::nullopt;
+}
 }  // namespace
 
 namespace bython::type_system
 {
-static auto const rules = std::array<subtype_rule const*, 7> {{&identity,
-                                                               &integer_promotion,
-                                                               &fp_promotion,
-                                                               &integer2floating_point,
-                                                               &number2bool,
-                                                               &bool2int,
-                                                               &bool2fp}};
-
 auto try_subtype_impl(ts::type const& tau, ts::type const& alpha)
     -> std::optional<ts::subtyping_rule>
 {
-  for (auto&& rule : rules) {
-    if (auto matching_rule = rule->try_subtype(tau, alpha); matching_rule) {
-      return matching_rule;
-    }
+  auto tau_kind = kind_of(tau);
+  auto alpha_kind = kind_of(alpha);
+
+  auto tau_index = matrix_index(tau_kind);
+  auto alpha_index = matrix_index(alpha_kind);
+  if (tau_index && alpha_index) {
+    return subtyping_matrix[*tau_index][*alpha_index];
   }
 
-  return std::nullopt;
+  // Function signatures are only subtypes of themselves. Interned types compare by address, the
+  // structural comparison covers types built outside of an environment
+  if (tau_kind.tag == ts::type_tag::function || alpha_kind.tag == ts::type_tag::function) {
+    return &tau == &alpha || tau == alpha ? std::optional {ts::subtyping_rule::identity}
+                                          : std::nullopt;
+  }
+
+  // Integers of unusual widths fall outside the matrix but follow the same rules
+  return derive_rule(tau_kind, alpha_kind);
 }
-}  // namespace bython::type_system
\ No newline at end of file
+}  // namespace bython::type_system
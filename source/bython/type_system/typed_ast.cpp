@@ -0,0 +1,32 @@
+#include <cassert>
+
+#include "typed_ast.hpp"
+
+namespace bython::type_system
+{
+auto typed_ast::type_of(ast::expression const& expr) const -> std::optional<type_system::type*>
+{
+  if (expr.id < this->m_expression_types.size() && this->m_expression_types[expr.id] != nullptr) {
+    return this->m_expression_types[expr.id];
+  }
+  return std::nullopt;
+}
+
+auto typed_ast::annotate(ast::expression const& expr, type_system::type* type) -> void
+{
+  if (expr.id >= this->m_expression_types.size()) {
+    this->m_expression_types.resize(expr.id + 1, nullptr);
+  }
+
+  // Two expressions sharing an id would silently overwrite each other's type
+  auto& slot = this->m_expression_types[expr.id];
+  assert(slot == nullptr && "Expression annotated twice");
+  ++this->m_annotated;
+  slot = type;
+}
+
+auto typed_ast::size() const -> std::size_t
+{
+  return this->m_annotated;
+}
+}  // namespace bython::type_system
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "builtin.hpp"
+#include "bython/ast/expression.hpp"
+
+namespace bython::type_system
+{
+/// Side-table holding the inferred type of every expression in an AST.
+/// Populated once by `environment::annotate`, after which lookups are O(1).
+class typed_ast
+{
+  // Indexed by ast::node_id; nullptr marks expressions that could not be inferred
+  std::vector<type_system::type*> m_expression_types;
+  std::size_t m_annotated = 0;
+
+public:
+  auto type_of(ast::expression const& expr) const -> std::optional<type_system::type*>;
+  auto annotate(ast::expression const& expr, type_system::type* type) -> void;
+
+  auto size() const -> std::size_t;
+};
+}  // namespace bython::type_system
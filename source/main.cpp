@@ -1,9 +1,16 @@
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <string>
 
+#include <bython/executors/aot.hpp>
 #include <bython/executors/jit.hpp>
+#include <bython/executors/repl.hpp>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
 
 enum class compilation_mode
 {
@@ -22,9 +29,13 @@ auto main(int argc, char* argv[]) -> int
   auto inpath = cl::opt<std::string>("inpath",
                                      cl::desc("File to just-in-time compile and execute"),
                                      cl::value_desc("filepath"),
-                                     cl::Required,
                                      cl::cat(jit_category));
 
+  auto repl = cl::opt<bool>("repl",
+                            cl::desc("Read and run inputs from stdin one at a time"),
+                            cl::init(false),
+                            cl::cat(jit_category));
+
   auto debug_values = cl::values(
       clEnumValN(compilation_mode::parse_only, "parse", "Disable optimisations, enable debugging"),
       clEnumValN(
@@ -37,9 +48,167 @@ auto main(int argc, char* argv[]) -> int
                                          cl::init(compilation_mode::full),
                                          cl::cat(jit_category));
 
+  using bython::backend::optimisation_level;
+  auto opt_values = cl::values(clEnumValN(optimisation_level::O0, "0", "No optimisation"),
+                               clEnumValN(optimisation_level::O1, "1", "Light optimisation"),
+                               clEnumValN(optimisation_level::O2, "2", "Default optimisation"),
+                               clEnumValN(optimisation_level::O3, "3", "Aggressive optimisation"),
+                               clEnumValN(optimisation_level::Os, "s", "Optimise for code size"));
+  auto opt_level = cl::opt<optimisation_level>("O",
+                                               cl::desc("Optimisation level in full mode"),
+                                               opt_values,
+                                               cl::Prefix,
+                                               cl::init(optimisation_level::O2),
+                                               cl::cat(jit_category));
+
+  auto lazy = cl::opt<bool>("lazy",
+                            cl::desc("Compile each function on its first call"),
+                            cl::init(false),
+                            cl::cat(jit_category));
+
+  using bython::backend::emit_kind;
+  auto emit_values = cl::values(clEnumValN(emit_kind::none, "none", "Only execute the program"),
+                                clEnumValN(emit_kind::ir, "ir", "Print the LLVM IR to stdout"),
+                                clEnumValN(emit_kind::assembly, "asm", "Print assembly to stdout"),
+                                clEnumValN(emit_kind::object, "obj", "Write <input>.o"));
+  auto emit = cl::opt<emit_kind>("emit",
+                                 cl::desc("Additionally emit the compiled module"),
+                                 emit_values,
+                                 cl::init(emit_kind::none),
+                                 cl::cat(jit_category));
+
+  auto cache_dir = cl::opt<std::string>("cache-dir",
+                                        cl::desc("Directory caching compiled programs"),
+                                        cl::value_desc("directory"),
+                                        cl::cat(jit_category));
+
+  auto outpath = cl::opt<std::string>("o",
+                                      cl::desc("Compile ahead of time into this executable"),
+                                      cl::value_desc("filepath"),
+                                      cl::cat(jit_category));
+
+  auto linker = cl::opt<std::string>("linker",
+                                      cl::desc("Compiler driver linking executables"),
+                                      cl::value_desc("program"),
+                                      cl::cat(jit_category));
+
+  auto runtime_library = cl::opt<std::string>("runtime-library",
+                                              cl::desc("bython_runtime archive to link against"),
+                                              cl::value_desc("filepath"),
+                                              cl::cat(jit_category));
+
+  auto mcpu = cl::opt<std::string>("mcpu",
+                                   cl::desc("Target CPU instead of the host's"),
+                                   cl::value_desc("cpu-name"),
+                                   cl::cat(jit_category));
+
+  auto mattr = cl::list<std::string>("mattr",
+                                     cl::desc("Target features to enable (+feature) or disable"),
+                                     cl::value_desc("a1,+a2,-a3,..."),
+                                     cl::CommaSeparated,
+                                     cl::cat(jit_category));
+
+  auto jobs = cl::opt<unsigned>("j",
+                                cl::desc("Threads generating code for the program's functions"),
+                                cl::value_desc("threads"),
+                                cl::Prefix,
+                                cl::init(1),
+                                cl::cat(jit_category));
+
+  using bython::executor::jit_listener;
+  auto listener_values = cl::values(
+      clEnumValN(jit_listener::perf_map, "perf-map", "Write /tmp/perf-<pid>.map for perf report"),
+      clEnumValN(jit_listener::jitdump, "jitdump", "Write a jitdump for perf inject --jit"),
+      clEnumValN(jit_listener::gdb, "gdb", "Register JIT'd code with GDB"));
+  auto listeners = cl::list<jit_listener>("jit-listener",
+                                          cl::desc("Tell profilers and debuggers about JIT'd code"),
+                                          listener_values,
+                                          cl::CommaSeparated,
+                                          cl::cat(jit_category));
+
+  auto time_trace = cl::opt<bool>("time-trace",
+                                  cl::desc("Record a Chrome trace of the compiler's phases"),
+                                  cl::init(false),
+                                  cl::cat(jit_category));
+
+  auto time_trace_file = cl::opt<std::string>(
+      "time-trace-file",
+      cl::desc("Where to write the trace, instead of <input stem>.time-trace"),
+      cl::value_desc("filepath"),
+      cl::cat(jit_category));
+
+  auto time_trace_granularity =
+      cl::opt<unsigned>("time-trace-granularity",
+                        cl::desc("Shortest scope recorded in the trace, in microseconds"),
+                        cl::init(500),
+                        cl::cat(jit_category));
+
   cl::HideUnrelatedOptions(jit_category);
   cl::ParseCommandLineOptions(argc, argv, "bython-jit");
 
-  auto jit = bython::executor::jit_compiler {};
-  return jit.execute(inpath.getValue());
+  auto target = bython::executor::target_options {
+      .cpu = mcpu.getValue(),
+      .features = {mattr.begin(), mattr.end()},
+  };
+
+  if (inpath.empty() && !repl) {
+    llvm::errs() << argv[0] << ": Either --inpath or --repl is required\n";
+    return 1;
+  }
+
+  auto compile_and_run = [&]() -> int
+  {
+    if (repl) {
+      auto options = bython::executor::repl_options {.target = target};
+      if (debug.getValue() == compilation_mode::full) {
+        options.opt_level = opt_level.getValue();
+      }
+
+      auto session = bython::executor::repl {options};
+      return session.run(std::cin, llvm::sys::Process::StandardInIsUserInput());
+    }
+
+    if (!outpath.empty()) {
+      auto aot = bython::executor::aot_compiler {
+          bython::executor::aot_options {.opt_level = opt_level.getValue(),
+                                         .target = target,
+                                         .codegen_threads = jobs.getValue(),
+                                         .linker = linker.getValue(),
+                                         .runtime_library = runtime_library.getValue()}};
+      return aot.compile(inpath.getValue(), outpath.getValue());
+    }
+
+    // Only full compilation optimises; the other modes keep the IR as emitted for debugging
+    auto options = bython::executor::jit_options {
+        .lazy = lazy.getValue(),
+        .emit = emit.getValue(),
+        .cache_directory = cache_dir.getValue(),
+        .target = target,
+        .codegen_threads = jobs.getValue(),
+        .listeners = {listeners.begin(), listeners.end()},
+    };
+    if (debug.getValue() == compilation_mode::full) {
+      options.opt_level = opt_level.getValue();
+    }
+
+    auto jit = bython::executor::jit_compiler {options};
+    return jit.execute(inpath.getValue());
+  };
+
+  if (!time_trace) {
+    return compile_and_run();
+  }
+
+  llvm::timeTraceProfilerInitialize(time_trace_granularity.getValue(), argv[0]);
+  auto status = compile_and_run();
+
+  // Traces are written even for failed compiles, since those are often the ones to triage
+  auto fallback =
+      repl ? std::string {"repl"} : std::filesystem::path {inpath.getValue()}.stem().string();
+  if (auto error = llvm::timeTraceProfilerWrite(time_trace_file.getValue(), fallback)) {
+    llvm::errs() << "Unable to write the time trace: " << llvm::toString(std::move(error)) << "\n";
+    status = status == 0 ? -1 : status;
+  }
+  llvm::timeTraceProfilerCleanup();
+  return status;
 }
@@ -0,0 +1,42 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "generator.hpp"
+#include "shape_options.hpp"
+
+namespace benchmark = bython::benchmark;
+
+auto main(int argc, char* argv[]) -> int
+{
+  namespace cl = llvm::cl;
+
+  auto category = cl::OptionCategory {"Generator Options", "Shape of the generated program"};
+
+  auto functions = cl::opt<std::size_t>(
+      "functions", cl::desc("Functions besides main"), cl::init(100), cl::cat(category));
+  auto shape = benchmark::shape_options {category};
+  auto outpath = cl::opt<std::string>("o",
+                                      cl::desc("Write the program here instead of stdout"),
+                                      cl::value_desc("filepath"),
+                                      cl::cat(category));
+
+  cl::HideUnrelatedOptions(category);
+  cl::ParseCommandLineOptions(argc, argv, "bython-generate");
+
+  auto program = benchmark::generate_program(shape.shape(functions));
+  if (outpath.empty()) {
+    std::cout << program;
+    return 0;
+  }
+
+  auto out = std::ofstream {outpath.getValue()};
+  if (!out) {
+    std::cerr << "Unable to open " << outpath.getValue() << "\n";
+    return 1;
+  }
+  out << program;
+  return 0;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "generator.hpp"
+
+namespace bython::benchmark
+{
+namespace
+{
+constexpr auto operators = std::array {" + ", " - ", " * ", " ^ ", " & ", " | "};
+
+class program_generator
+{
+public:
+  explicit program_generator(program_shape const& shape)
+      : m_shape {shape}
+      , m_random {shape.seed}
+  {
+  }
+
+  auto generate() -> std::string
+  {
+    // Callees have higher indices than their callers, so emitting in reverse defines every
+    // function before its first use
+    for (auto index = this->m_shape.functions; index-- > 0;) {
+      this->function(index);
+    }
+
+    this->m_code += "def main()\n{\n";
+    if (this->m_shape.functions > 0) {
+      this->m_code += "    val result: u64 = f0();\n";
+    }
+    this->m_code += "}\n";
+    return std::move(this->m_code);
+  }
+
+private:
+  auto callees(std::size_t index) -> std::vector<std::size_t>
+  {
+    auto const functions = this->m_shape.functions;
+    auto result = std::vector<std::size_t> {};
+    switch (this->m_shape.calls) {
+      case call_graph::none:
+        break;
+      case call_graph::chain:
+        result.push_back(index + 1);
+        break;
+      case call_graph::tree:
+        result.push_back(2 * index + 1);
+        result.push_back(2 * index + 2);
+        break;
+      case call_graph::random:
+        if (index + 1 < functions) {
+          auto pick = std::uniform_int_distribution<std::size_t> {index + 1, functions - 1};
+          result.push_back(pick(this->m_random));
+          result.push_back(pick(this->m_random));
+        }
+        break;
+    }
+
+    std::erase_if(result, [&](auto callee) { return callee >= functions; });
+    return result;
+  }
+
+  auto function(std::size_t index) -> void
+  {
+    auto const statements = std::max<std::size_t>(this->m_shape.statements, 1);
+    auto const calls = this->callees(index);
+
+    this->m_code += "def f" + std::to_string(index) + "() -> u64\n{\n";
+    for (auto binding = std::size_t {0}; binding < statements; ++binding) {
+      this->m_code += "    val v" + std::to_string(binding) + ": u64 = ";
+      this->expression(binding, this->m_shape.depth);
+
+      // Each binding but the last makes at most one call; the last makes whatever remains
+      auto const last_call =
+          binding + 1 == statements ? calls.size() : std::min(binding + 1, calls.size());
+      for (auto call = binding; call < last_call; ++call) {
+        this->m_code += " + f" + std::to_string(calls[call]) + "()";
+      }
+      this->m_code += ";\n";
+    }
+    this->m_code += "    return v" + std::to_string(statements - 1) + ";\n}\n";
+  }
+
+  // `width` operands, one of which nests the next level in parentheses while `depth` remains
+  auto expression(std::size_t binding, std::size_t depth) -> void
+  {
+    auto const width = std::max<std::size_t>(this->m_shape.width, 1);
+    auto nested_at = std::uniform_int_distribution<std::size_t> {0, width - 1}(this->m_random);
+    auto op = std::uniform_int_distribution<std::size_t> {0, operators.size() - 1};
+
+    for (auto operand = std::size_t {0}; operand < width; ++operand) {
+      if (operand > 0) {
+        this->m_code += operators[op(this->m_random)];
+      }
+
+      if (depth > 0 && operand == nested_at) {
+        this->m_code += "(";
+        this->expression(binding, depth - 1);
+        this->m_code += ")";
+      } else {
+        this->leaf(binding);
+      }
+    }
+  }
+
+  // An earlier binding or a literal. Codegen does not promote the operands of arithmetic, so
+  // literals are converted to the u64 of everything else
+  auto leaf(std::size_t binding) -> void
+  {
+    auto choice = std::uniform_int_distribution<std::size_t> {0, binding}(this->m_random);
+    if (choice < binding) {
+      this->m_code += "v" + std::to_string(choice);
+    } else {
+      auto literal = std::uniform_int_distribution<int> {1, 255}(this->m_random);
+      this->m_code += std::to_string(literal) + " as u64";
+    }
+  }
+
+  program_shape m_shape;
+  std::mt19937_64 m_random;
+  std::string m_code;
+};
+}  // namespace
+
+auto generate_program(program_shape const& shape) -> std::string
+{
+  return program_generator {shape}.generate();
+}
+}  // namespace bython::benchmark
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bython::benchmark
+{
+/// Which earlier-emitted functions each generated function calls
+enum class call_graph
+{
+  // No calls besides `main` calling the root
+  none,
+  // Every function calls the next, so the call stack is as deep as the module is long
+  chain,
+  // Every function calls its two children in a balanced binary tree
+  tree,
+  // Every function calls up to two functions picked at random from the ones already emitted
+  random,
+};
+
+/// Knobs of a synthetic program. Every generated function is `def fN() -> u64` and returns its
+/// last binding, so the program is valid for any combination of knobs. Parameters are left out,
+/// since neither inference nor codegen binds them yet.
+struct program_shape
+{
+  std::size_t functions = 100;
+  // `val` bindings in each function body
+  std::size_t statements = 4;
+  // Parenthesised levels of each binding's initialiser
+  std::size_t depth = 2;
+  // Operands per level of an initialiser
+  std::size_t width = 3;
+  call_graph calls = call_graph::chain;
+  std::uint64_t seed = 0;
+};
+
+/// Emits a module of `shape.functions` functions followed by a `main` calling the root of the
+/// call graph. Callees are always emitted before their callers, as type inference expects.
+auto generate_program(program_shape const& shape) -> std::string;
+}  // namespace bython::benchmark
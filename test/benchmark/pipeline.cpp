@@ -0,0 +1,168 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include "bython/ast.hpp"
+#include "bython/backend/llvm.hpp"
+#include "bython/executors/jit.hpp"
+#include "bython/frontend/frontend.hpp"
+#include "bython/frontend/lexy.hpp"
+#include "bython/type_system.hpp"
+#include "generator.hpp"
+
+namespace ast = bython::ast;
+namespace ts = bython::type_system;
+namespace p = bython::parser;
+
+namespace
+{
+/// A chain of `functions` functions, with `main` at its end. It prints nothing, so benchmark
+/// output stays clean.
+auto synthetic_module(std::size_t functions) -> std::string
+{
+  return bython::benchmark::generate_program(
+      bython::benchmark::program_shape {.functions = functions});
+}
+
+// The metadata only views `code`, so callers keep it alive for as long as they use the metadata
+auto parse(std::string const& code) -> p::frontend_parse_result::value_type
+{
+  auto parser = p::lexy_code_frontend {};
+  auto result = parser.parse(code);
+  REQUIRE(result.has_value());
+  return std::move(result).value();
+}
+
+auto module_sizes() -> std::size_t
+{
+  return GENERATE(as<std::size_t> {}, 10, 100, 1000);
+}
+}  // namespace
+
+TEST_CASE("Frontend", "[Benchmark]")
+{
+  auto functions = module_sizes();
+  auto code = synthetic_module(functions);
+
+  BENCHMARK("parse " + std::to_string(functions) + " functions")
+  {
+    return p::lexy_code_frontend {}.parse(code);
+  };
+}
+
+TEST_CASE("Type checking", "[Benchmark]")
+{
+  auto functions = module_sizes();
+  auto code = synthetic_module(functions);
+  auto [metadata, tree] = parse(code);
+
+  BENCHMARK("annotate " + std::to_string(functions) + " functions")
+  {
+    auto env = ts::environment::initialise_with_builtins();
+    return env.annotate(*tree);
+  };
+
+  // A single expression whose operands nest `functions` levels deep
+  auto expression = std::string {"1"};
+  for (auto i = std::size_t {1}; i < functions; ++i) {
+    expression += " + " + std::to_string(i % 200);
+  }
+  auto parsed = p::lexy_code_frontend {}.parse_expression(expression);
+  REQUIRE(parsed.has_value());
+  auto [expr_metadata, expr_tree] = std::move(parsed).value();
+  auto const& expr = ast::cast<ast::expression>(*expr_tree);
+
+  BENCHMARK("get_type of " + std::to_string(functions) + " operands")
+  {
+    auto env = ts::environment::initialise_with_builtins();
+    return env.get_type(expr);
+  };
+}
+
+TEST_CASE("Code generation", "[Benchmark]")
+{
+  auto functions = module_sizes();
+  auto code = synthetic_module(functions);
+  auto [metadata, tree] = parse(code);
+
+  BENCHMARK_ADVANCED("compile " + std::to_string(functions) + " functions")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    auto contexts = std::vector<llvm::LLVMContext>(static_cast<std::size_t>(meter.runs()));
+    meter.measure(
+        [&](int run)
+        { return bython::backend::compile("benchmark", *tree, *metadata, contexts[run]); });
+  };
+}
+
+TEST_CASE("JIT finalisation", "[Benchmark]")
+{
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  auto functions = module_sizes();
+  auto code = synthetic_module(functions);
+  auto [metadata, tree] = parse(code);
+
+  BENCHMARK_ADVANCED("materialise " + std::to_string(functions) + " functions")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    // Modules are generated up front, so that only adding them and looking up `main` is timed
+    auto modules = std::vector<llvm::orc::ThreadSafeModule> {};
+    auto jits = std::vector<std::unique_ptr<llvm::orc::LLJIT>> {};
+    for (auto run = 0; run < meter.runs(); ++run) {
+      auto context = std::make_unique<llvm::LLVMContext>();
+      auto module_ = bython::backend::compile("benchmark", *tree, *metadata, *context);
+
+      auto jit = llvm::orc::LLJITBuilder {}.create();
+      REQUIRE(jit);
+      module_->setDataLayout((*jit)->getDataLayout());
+
+      modules.emplace_back(std::move(module_), std::move(context));
+      jits.push_back(std::move(*jit));
+    }
+
+    meter.measure(
+        [&](int run)
+        {
+          auto& jit = *jits[run];
+          llvm::cantFail(jit.addIRModule(std::move(modules[run])));
+          return llvm::cantFail(jit.lookup("main"));
+        });
+  };
+}
+
+TEST_CASE("End to end", "[Benchmark]")
+{
+  auto functions = module_sizes();
+
+  auto input_file = std::filesystem::temp_directory_path()
+      / ("bython_benchmark_" + std::to_string(functions) + ".by");
+  std::ofstream {input_file} << synthetic_module(functions);
+
+  auto const options =
+      bython::executor::jit_options {.opt_level = bython::backend::optimisation_level::O2};
+
+  // The benchmark discards the exit code, so a program that fails to compile would time as fast
+  REQUIRE(bython::executor::jit_compiler {options}.execute(input_file) == 0);
+
+  BENCHMARK("execute " + std::to_string(functions) + " functions")
+  {
+    auto jit = bython::executor::jit_compiler {options};
+    return jit.execute(input_file);
+  };
+
+  std::filesystem::remove(input_file);
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CommandLine.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bython/ast.hpp"
+#include "bython/backend/llvm.hpp"
+#include "bython/frontend/frontend.hpp"
+#include "bython/frontend/lexy.hpp"
+#include "bython/type_system.hpp"
+#include "generator.hpp"
+#include "shape_options.hpp"
+
+namespace ts = bython::type_system;
+namespace p = bython::parser;
+namespace benchmark = bython::benchmark;
+
+namespace
+{
+template<typename Stage>
+auto milliseconds(Stage&& stage) -> double
+{
+  auto const start = std::chrono::steady_clock::now();
+  stage();
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+auto peak_rss_kib() -> long
+{
+  auto usage = rusage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// Runs every stage on one program and prints its row; returns false if any stage failed
+auto measure(benchmark::program_shape const& shape, unsigned threads) -> bool
+{
+  auto code = benchmark::generate_program(shape);
+  auto lines = std::count(code.begin(), code.end(), '\n');
+
+  auto parsed = std::optional<p::frontend_parse_result> {};
+  auto parse_ms = milliseconds([&] { parsed.emplace(p::lexy_code_frontend {}.parse(code)); });
+  if (parsed->has_error()) {
+    std::cerr << std::move(*parsed).error() << "\n";
+    return false;
+  }
+  auto [metadata, tree] = std::move(*parsed).value();
+
+  auto fold_ms = milliseconds([&] { bython::ast::fold_constants(*tree); });
+
+  auto typecheck_ms = milliseconds(
+      [&]
+      {
+        auto env = ts::environment::initialise_with_builtins();
+        env.annotate(*tree);
+      });
+
+  // `compile` infers the module's types again before lowering it, so this includes a second
+  // type check; subtract the column before it for codegen alone
+  auto context = llvm::LLVMContext {};
+  auto module_ = std::unique_ptr<llvm::Module> {};
+  auto compile_ms = milliseconds(
+      [&] { module_ = bython::backend::compile("scaling", *tree, *metadata, context, threads); });
+
+  std::cout << shape.functions << ',' << lines << ',' << code.size() << ',' << parse_ms << ','
+            << fold_ms << ',' << typecheck_ms << ',' << compile_ms << ',' << peak_rss_kib()
+            << std::endl;
+  return module_ != nullptr;
+}
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+  namespace cl = llvm::cl;
+
+  auto category = cl::OptionCategory {"Scaling Options", "Programs to measure the pipeline on"};
+
+  auto sizes = cl::list<std::size_t>("functions",
+                                     cl::desc("Function counts to measure, smallest first"),
+                                     cl::CommaSeparated,
+                                     cl::cat(category));
+  auto shape = benchmark::shape_options {category};
+  auto threads = cl::opt<unsigned>(
+      "j", cl::desc("Threads generating code"), cl::Prefix, cl::init(1), cl::cat(category));
+
+  cl::HideUnrelatedOptions(category);
+  cl::ParseCommandLineOptions(argc, argv, "bython-scaling");
+
+  auto functions = std::vector<std::size_t>(sizes.begin(), sizes.end());
+  if (functions.empty()) {
+    functions = {100, 1000, 10000, 20000};
+  }
+
+  std::cout << "functions,lines,bytes,parse_ms,fold_ms,typecheck_ms,compile_ms,peak_rss_kib"
+            << std::endl;
+
+  // Each size runs in its own process, so peak RSS is not inherited from a larger predecessor
+  auto failed = false;
+  for (auto count : functions) {
+    auto child = fork();
+    if (child == 0) {
+      _exit(measure(shape.shape(count), threads) ? 0 : 1);
+    }
+
+    auto status = 0;
+    if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status)
+        || WEXITSTATUS(status) != 0)
+    {
+      std::cerr << "Measuring " << count << " functions failed\n";
+      failed = true;
+    }
+  }
+  return failed ? 1 : 0;
+}
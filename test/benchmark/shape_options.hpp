@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "generator.hpp"
+
+namespace bython::benchmark
+{
+/// Command line options describing a `program_shape`, shared by the generator and the harness
+struct shape_options
+{
+  explicit shape_options(llvm::cl::OptionCategory& category)
+      : statements {"statements",
+                    llvm::cl::desc("Bindings in each function"),
+                    llvm::cl::init(4),
+                    llvm::cl::cat(category)}
+      , depth {"depth",
+               llvm::cl::desc("Nesting depth of each initialiser"),
+               llvm::cl::init(2),
+               llvm::cl::cat(category)}
+      , width {"width",
+               llvm::cl::desc("Operands per nesting level"),
+               llvm::cl::init(3),
+               llvm::cl::cat(category)}
+      , calls {"calls",
+               llvm::cl::desc("Shape of the call graph"),
+               llvm::cl::values(
+                   clEnumValN(call_graph::none, "none", "Functions call nothing"),
+                   clEnumValN(call_graph::chain, "chain", "Each function calls the next"),
+                   clEnumValN(call_graph::tree, "tree", "Binary tree of calls"),
+                   clEnumValN(call_graph::random, "random", "Random acyclic calls")),
+               llvm::cl::init(call_graph::chain),
+               llvm::cl::cat(category)}
+      , seed {"seed",
+              llvm::cl::desc("Seed of the operand and operator choices"),
+              llvm::cl::init(0),
+              llvm::cl::cat(category)}
+  {
+  }
+
+  auto shape(std::size_t functions) const -> program_shape
+  {
+    return program_shape {.functions = functions,
+                          .statements = this->statements,
+                          .depth = this->depth,
+                          .width = this->width,
+                          .calls = this->calls,
+                          .seed = this->seed};
+  }
+
+  llvm::cl::opt<std::size_t> statements;
+  llvm::cl::opt<std::size_t> depth;
+  llvm::cl::opt<std::size_t> width;
+  llvm::cl::opt<call_graph> calls;
+  llvm::cl::opt<std::uint64_t> seed;
+};
+}  // namespace bython::benchmark
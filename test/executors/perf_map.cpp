@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include "bython/executors/perf_map.hpp"
+
+namespace
+{
+/// A module holding only an empty `void main()`
+auto empty_main() -> llvm::orc::ThreadSafeModule
+{
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto module_ = std::make_unique<llvm::Module>("perf_map", *context);
+
+  auto* type = llvm::FunctionType::get(llvm::Type::getVoidTy(*context), /*isVarArg=*/false);
+  auto* main = llvm::Function::Create(type, llvm::Function::ExternalLinkage, "main", *module_);
+  auto builder = llvm::IRBuilder<> {llvm::BasicBlock::Create(*context, "entry", main)};
+  builder.CreateRetVoid();
+
+  return {std::move(module_), std::move(context)};
+}
+
+auto read_lines(std::filesystem::path const& path) -> std::vector<std::string>
+{
+  auto lines = std::vector<std::string> {};
+  auto in = std::ifstream {path};
+  for (auto line = std::string {}; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+}  // namespace
+
+TEST_CASE("JIT'd functions are written to the perf map", "[Executors]")
+{
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  auto path = std::filesystem::temp_directory_path() / "bython_test_perf.map";
+  std::filesystem::remove(path);
+
+  {
+    // The JIT only borrows the listener, so it is destroyed first
+    auto listener = bython::executor::perf_map_listener {path};
+
+    auto builder = llvm::orc::LLJITBuilder {};
+    builder.setObjectLinkingLayerCreator(
+        [&](llvm::orc::ExecutionSession& session, llvm::Triple const& /*triple*/)
+            -> llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>>
+        {
+          auto layer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+              session, [] { return std::make_unique<llvm::SectionMemoryManager>(); });
+          layer->registerJITEventListener(listener);
+          return layer;
+        });
+
+    auto jit = builder.create();
+    REQUIRE(jit);
+    llvm::cantFail((*jit)->addIRModule(empty_main()));
+    llvm::cantFail((*jit)->lookup("main"));
+  }
+
+  auto const entry = std::regex {"[0-9a-f]+ [0-9a-f]+ main"};
+  auto lines = read_lines(path);
+  std::filesystem::remove(path);
+
+  CAPTURE(lines);
+  REQUIRE(std::ranges::any_of(lines,
+                              [&](auto const& line) { return std::regex_match(line, entry); }));
+}
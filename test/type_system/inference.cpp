@@ -1,9 +1,13 @@
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <vector>
 
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -44,17 +48,18 @@ auto parse_expression(std::string_view code)
     FAIL();
   }
 
-  auto [metadata, node] = std::move(result).value();
+  auto [metadata, tree] = std::move(result).value();
 
-  auto node_as_sp = std::shared_ptr<ast::node>(std::move(node));
-  auto expr_as_sp = std::dynamic_pointer_cast<ast::expression>(node_as_sp);
-  if (!expr_as_sp) {
+  // The expression shares ownership of the tree, which owns the arena backing the nodes
+  auto tree_as_sp = std::make_shared<ast::tree>(std::move(tree));
+  auto* expr = ast::dyn_cast<ast::expression>(tree_as_sp->get());
+  if (expr == nullptr) {
     metadata->report_error(
-        *node_as_sp, p::frontend_error_report {.message = "Code must be parsed as an expression"});
+        **tree_as_sp, p::frontend_error_report {.message = "Code must be parsed as an expression"});
     FAIL();
   }
 
-  return std::make_tuple(std::move(metadata), std::move(expr_as_sp));
+  return std::make_tuple(std::move(metadata), std::shared_ptr<ast::expression>(tree_as_sp, expr));
 }
 }  // namespace
 
@@ -162,4 +167,164 @@ TEST_CASE("Binary Operations", "[Inference]")
     REQUIRE(inferred_u64i8);
     REQUIRE(*inferred_u64i8 == *env.lookup_type("u64"));
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Annotation", "[Inference]")
+{
+  auto env = ts::environment::initialise_with_builtins();
+
+  static auto parser = p::lexy_code_frontend {};
+  auto result = parser.parse("def main() { val x: u64 = 1 + 2 * 3; discard put_u64(x); }");
+  REQUIRE(result.has_value());
+
+  auto [metadata, node] = std::move(result).value();
+  auto types = env.annotate(*node);
+
+  auto const& module_ = ast::cast<ast::mod>(*node);
+  auto const& main = ast::cast<ast::function_def>(*module_.body.front());
+  auto const& assgn = ast::cast<ast::let_assignment>(*main.body[0]);
+  auto const& discard = ast::cast<ast::expression_statement>(*main.body[1]);
+
+  SECTION("Every expression is annotated exactly once")
+  {
+    auto const& sum = ast::cast<ast::binary_operation>(*assgn.rhs);
+    auto const& product = ast::cast<ast::binary_operation>(*sum.rhs);
+    auto const& call = ast::cast<ast::call>(*discard.discarded);
+    auto const expressions = std::array<ast::expression const*, 7> {
+        sum.lhs.get(),
+        product.lhs.get(),
+        product.rhs.get(),
+        &product,
+        &sum,
+        call.arguments.arguments.front().get(),
+        &call,
+    };
+
+    // Distinct ids mean no annotation can have overwritten another
+    auto ids = std::set<ast::node_id> {};
+    for (auto const* expr : expressions) {
+      REQUIRE(types.type_of(*expr));
+      ids.insert(expr->id);
+    }
+    REQUIRE(ids.size() == expressions.size());
+    REQUIRE(types.size() == expressions.size());
+  }
+
+  SECTION("Annotations agree with on-demand inference")
+  {
+    auto const& sum = ast::cast<ast::binary_operation>(*assgn.rhs);
+    REQUIRE(types.type_of(sum) == env.lookup_type("u8"));
+    REQUIRE(types.type_of(*sum.lhs) == env.get_type(*sum.lhs));
+    REQUIRE(types.type_of(*sum.rhs) == env.get_type(*sum.rhs));
+  }
+
+  SECTION("Bindings are registered in program order")
+  {
+    REQUIRE(env.lookup_symbol("main"));
+    REQUIRE_FALSE(env.lookup_symbol("x"));
+
+    auto const& call = ast::cast<ast::call>(*discard.discarded);
+    REQUIRE(types.type_of(*call.arguments.arguments.front()) == env.lookup_type("u64"));
+    REQUIRE(types.type_of(call) == env.lookup_type("void"));
+  }
+
+  SECTION("Identifiers are interned to shared symbols")
+  {
+    auto const& call = ast::cast<ast::call>(*discard.discarded);
+    auto const& argument = ast::cast<ast::variable>(*call.arguments.arguments.front());
+    REQUIRE(main.sig.name == ast::symbols::main);
+    REQUIRE(assgn.hint == ast::symbols::u64);
+    REQUIRE(call.callee == ast::symbols::put_u64);
+    REQUIRE(argument.identifier == assgn.lhs);
+    REQUIRE(ast::spelling(assgn.lhs) == "x");
+  }
+}
+
+TEST_CASE("Function bodies are scoped", "[Inference]")
+{
+  auto env = ts::environment::initialise_with_builtins();
+
+  static auto parser = p::lexy_code_frontend {};
+  auto result = parser.parse(
+      "def f() { val x: u8 = 1; val y: u8 = x; } "
+      "def g() { val x: f64 = 2 as f64; val y: f64 = x; }");
+  REQUIRE(result.has_value());
+
+  auto [metadata, node] = std::move(result).value();
+  auto types = env.annotate(*node);
+
+  auto const& module_ = ast::cast<ast::mod>(*node);
+  auto binding_in = [&](std::size_t function)
+  {
+    auto const& fdef = ast::cast<ast::function_def>(*module_.body[function]);
+    return types.type_of(*ast::cast<ast::let_assignment>(*fdef.body[1]).rhs);
+  };
+
+  REQUIRE(binding_in(0) == env.lookup_type("u8"));
+  REQUIRE(binding_in(1) == env.lookup_type("f64"));
+  REQUIRE(env.lookup_symbol("f"));
+  REQUIRE_FALSE(env.lookup_symbol("x"));
+}
+
+TEST_CASE("Types are interned", "[Inference]")
+{
+  auto env = ts::environment::initialise_with_builtins();
+
+  SECTION("Structurally equal named types share one object")
+  {
+    auto* alias = env.add_new_named_type(ast::intern("int64"), std::make_unique<ts::sint>(64));
+    REQUIRE(alias == env.lookup_type("i64"));
+  }
+
+  SECTION("Functions with the same signature share one type")
+  {
+    auto parameters = std::vector {ast::parameter {ast::intern("value"), ast::symbols::i64}};
+    auto signature = ast::signature {
+        ast::intern("print"), ast::parameter_list {std::move(parameters)}, std::nullopt};
+
+    auto function_type = env.add_new_function_type(signature);
+    REQUIRE(function_type);
+    REQUIRE(*function_type == env.lookup_symbol("put_i64"));
+  }
+}
+
+TEST_CASE("Constant folding", "[Inference]")
+{
+  auto env = ts::environment::initialise_with_builtins();
+  auto [metadata, expr] = parse_expression("((1 << 4) | 3) < 200 + 100");
+
+  auto root_type = env.get_type(*expr);
+  REQUIRE(ast::fold_constants(*expr) == 3);
+
+  auto const& folded = ast::cast<ast::comparison>(*expr);
+  auto const* lhs = ast::dyn_cast<ast::unsigned_integer>(*folded.lhs);
+  auto const* rhs = ast::dyn_cast<ast::unsigned_integer>(*folded.rhs);
+
+  SECTION("Operations on literals evaluate with codegen's semantics")
+  {
+    REQUIRE(lhs != nullptr);
+    REQUIRE(lhs->value == 19);
+
+    // u8 + u8 wraps around at 8 bits
+    REQUIRE(rhs != nullptr);
+    REQUIRE(rhs->value == 44);
+  }
+
+  SECTION("Folded literals keep the type of the operation they replace")
+  {
+    REQUIRE(env.get_type(*folded.lhs) == env.lookup_type("u8"));
+    REQUIRE(env.get_type(*folded.rhs) == env.lookup_type("u8"));
+    REQUIRE(env.get_type(*expr) == root_type);
+  }
+}
+
+TEST_CASE("Operations without codegen are not folded", "[Inference]")
+{
+  auto expression = GENERATE(as<std::string_view> {}, "-(5) + 1", "~5 + 1");
+  auto [metadata, expr] = parse_expression(expression);
+
+  REQUIRE(ast::fold_constants(*expr) == 0);
+
+  auto const& sum = ast::cast<ast::binary_operation>(*expr);
+  REQUIRE(ast::isa<ast::unary_operation>(*sum.lhs));
+}